@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "constants.h"
+
+// Growable array for small trivially-copyable items (pointers, ids, counters).
+// Capacity doubles when full, so append() is amortized O(1).
+// Items can move when the array grows: keep indices, not addresses.
+template<typename T>
+class GrowArray {
+    static_assert(std::is_trivially_copyable<T>::value, "GrowArray holds plain values only");
+
+    T* m_data;
+    int m_count;
+    int m_cap;
+
+public:
+    GrowArray() : m_data(nullptr), m_count(0), m_cap(0) {}
+    ~GrowArray() { delete[] m_data; }
+
+    GrowArray(const GrowArray&) = delete;
+    GrowArray& operator=(const GrowArray&) = delete;
+
+    void reserve(int n) {
+        if (n <= m_cap) return;
+        T* grown = new T[n];
+        if (m_count) std::memcpy(static_cast<void*>(grown), m_data, sizeof(T) * m_count);
+        delete[] m_data;
+        m_data = grown;
+        m_cap = n;
+    }
+
+    void append(const T& v) {
+        if (m_count == m_cap) reserve(m_cap ? m_cap * 2 : 4);
+        m_data[m_count++] = v;
+    }
+
+    bool contains(const T& v) const {
+        for (int i = 0; i < m_count; i++)
+            if (m_data[i] == v) return true;
+        return false;
+    }
+
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    T& operator[](int i) { return m_data[i]; }
+    const T& operator[](int i) const { return m_data[i]; }
+    void removeLast() { if (m_count > 0) m_count--; }
+    void clear() { m_count = 0; }
+    void resize(int n) { reserve(n); m_count = n; } // new items are uninitialized
+};
+
+// Object pool carved out of fixed-size slabs (ARENA_SLAB_SIZE objects each).
+// - create() is a bump into the current slab; a new slab is allocated only every
+//   ARENA_SLAB_SIZE objects, so there is no per-object new/delete.
+// - Objects never move: pointers stay valid for the arena's whole lifetime.
+// - Objects are destroyed together when the arena goes away.
+// Objects are also reachable by creation order through at(i).
+// Threads: create() calls must be serialized by the owner, but at()/count() may
+// run alongside them lock-free. An outgrown slab directory is kept (not freed)
+// until the arena dies, so a reader holding the old one stays valid.
+template<typename T>
+class SlabArena {
+    std::atomic<T**> m_dir; // slab pointers
+    int m_dirCap;
+    GrowArray<T**> m_retired;
+    std::atomic<int> m_count;
+
+public:
+    SlabArena() : m_dir(nullptr), m_dirCap(0), m_count(0) {}
+    ~SlabArena() {
+        int n = m_count.load(std::memory_order_relaxed);
+        T** dir = m_dir.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++) (dir[i / ARENA_SLAB_SIZE] + (i % ARENA_SLAB_SIZE))->~T();
+        for (int s = 0; s < (n + ARENA_SLAB_SIZE - 1) / ARENA_SLAB_SIZE; s++) ::operator delete(static_cast<void*>(dir[s]));
+        delete[] dir;
+        for (int i = 0; i < m_retired.count(); i++) delete[] m_retired[i];
+    }
+
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        int n = m_count.load(std::memory_order_relaxed);
+        int slab = n / ARENA_SLAB_SIZE;
+        int slot = n % ARENA_SLAB_SIZE;
+        T** dir = m_dir.load(std::memory_order_relaxed);
+
+        if (slot == 0) {
+            if (slab == m_dirCap) {
+                int cap = m_dirCap ? m_dirCap * 2 : 8;
+                T** grown = new T*[cap];
+                if (m_dirCap) std::memcpy(static_cast<void*>(grown), dir, sizeof(T*) * m_dirCap);
+                if (dir) m_retired.append(dir);
+                m_dirCap = cap;
+                dir = grown;
+            }
+            dir[slab] = static_cast<T*>(::operator new(sizeof(T) * ARENA_SLAB_SIZE));
+            m_dir.store(dir, std::memory_order_release);
+        }
+
+        T* obj = new (dir[slab] + slot) T(std::forward<Args>(args)...);
+        m_count.store(n + 1, std::memory_order_release); // publish
+        return obj;
+    }
+
+    int count() const { return m_count.load(std::memory_order_acquire); }
+    T* at(int i) const {
+        if (i < 0 || i >= count()) return nullptr;
+        T** dir = m_dir.load(std::memory_order_acquire);
+        return dir[i / ARENA_SLAB_SIZE] + (i % ARENA_SLAB_SIZE);
+    }
+};
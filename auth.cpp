@@ -0,0 +1,101 @@
+#include "auth.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+
+static QByteArray randomBytes(int n) {
+    QByteArray out(n, '\0');
+    for (int i = 0; i < n; i++)
+        out[i] = char(QRandomGenerator::system()->generate() & 0xff);
+    return out;
+}
+
+// constant time, so a wrong guess does not leak how many bytes matched
+static bool sameBytes(const QByteArray& a, const QByteArray& b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (int i = 0; i < a.size(); i++) diff |= (unsigned char)(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+// ----------------- PasswordHasher -----------------
+QByteArray PasswordHasher::pbkdf2(const QByteArray& pass, const QByteArray& salt, int iterations) {
+    // single block is enough: output length == SHA-256 length
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, pass);
+
+    mac.addData(salt);
+    mac.addData(QByteArray("\x00\x00\x00\x01", 4));
+    QByteArray u = mac.result();
+    QByteArray out = u;
+
+    for (int i = 1; i < iterations; i++) {
+        mac.reset();
+        mac.addData(u);
+        u = mac.result();
+        for (int j = 0; j < out.size(); j++) out[j] = char(out[j] ^ u[j]);
+    }
+    return out;
+}
+
+PasswordRecord PasswordHasher::make(const QString& pass, int iterations) {
+    PasswordRecord rec;
+    rec.salt = randomBytes(PASSWORD_SALT_BYTES);
+    rec.iterations = iterations;
+    rec.hash = pbkdf2(pass.toUtf8(), rec.salt, iterations);
+    return rec;
+}
+
+bool PasswordHasher::verify(const PasswordRecord& rec, const QString& pass) {
+    if (rec.iterations <= 0 || rec.hash.isEmpty()) return false;
+    return sameBytes(pbkdf2(pass.toUtf8(), rec.salt, rec.iterations), rec.hash);
+}
+
+// ----------------- SessionCache -----------------
+SessionCache::SessionCache(int ttlSecs)
+    : m_secret(randomBytes(32)), m_ttlSecs(ttlSecs), m_purgeAt(1024) {
+}
+
+QByteArray SessionCache::token(int userId, const QString& pass) const {
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, m_secret);
+    mac.addData(QByteArray::number(userId));
+    mac.addData(QByteArray("\0", 1));
+    mac.addData(pass.toUtf8());
+    return mac.result();
+}
+
+bool SessionCache::check(int userId, const QString& pass) const {
+    Entry e;
+    {
+        QReadLocker lock(&m_lock);
+        auto it = m_entries.constFind(userId);
+        if (it == m_entries.constEnd()) return false;
+        e = it.value();
+    }
+    if (e.expiresAt < QDateTime::currentSecsSinceEpoch()) return false;
+    return sameBytes(e.token, token(userId, pass));
+}
+
+void SessionCache::remember(int userId, const QString& pass) {
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    QByteArray t = token(userId, pass);
+    QWriteLocker lock(&m_lock);
+    // keep the table bounded by the number of recent logins (amortized sweep)
+    if (m_entries.size() >= m_purgeAt) {
+        purgeExpired(now);
+        m_purgeAt = qMax(1024, int(m_entries.size()) * 2);
+    }
+    m_entries.insert(userId, Entry{ t, now + m_ttlSecs });
+}
+
+void SessionCache::forget(int userId) {
+    QWriteLocker lock(&m_lock);
+    m_entries.remove(userId);
+}
+
+void SessionCache::purgeExpired(qint64 now) {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it.value().expiresAt < now) it = m_entries.erase(it);
+        else ++it;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include "constants.h"
+
+// Stored form of a password: PBKDF2-HMAC-SHA256(pass, salt, iterations).
+struct PasswordRecord {
+    QByteArray salt;
+    QByteArray hash;
+    int iterations = 0;
+};
+
+class PasswordHasher {
+public:
+    static PasswordRecord make(const QString& pass, int iterations = PASSWORD_HASH_ITERATIONS);
+    static bool verify(const PasswordRecord& rec, const QString& pass);
+
+private:
+    static QByteArray pbkdf2(const QByteArray& pass, const QByteArray& salt, int iterations);
+};
+
+// Short-lived cache of successful logins.
+// A re-login within the TTL is checked with one keyed hash instead of the full PBKDF2 run.
+// Only a keyed digest of the password is kept, never the password itself.
+// Safe to share between threads.
+class SessionCache {
+    struct Entry {
+        QByteArray token;
+        qint64 expiresAt;
+    };
+
+    mutable QReadWriteLock m_lock;
+    QHash<int, Entry> m_entries; // userId -> entry
+    QByteArray m_secret;         // per-process random key
+    int m_ttlSecs;
+    int m_purgeAt;
+
+    QByteArray token(int userId, const QString& pass) const;
+    void purgeExpired(qint64 now);
+
+public:
+    explicit SessionCache(int ttlSecs = SESSION_CACHE_TTL_SECS);
+
+    bool check(int userId, const QString& pass) const;
+    void remember(int userId, const QString& pass);
+    void forget(int userId);
+};
@@ -0,0 +1,75 @@
+// Lookup cost of EntityIndex vs. the old linear scan, from 100 to 1,000,000 entities.
+// Run: ./lms_index_bench
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "../entity_index.h"
+
+struct BenchEntity {
+    int m_id;
+    int id() const { return m_id; }
+};
+
+static const int LOOKUPS = 1000000;
+static const int LINEAR_LOOKUPS = 2000;
+static const int LINEAR_MAX_N = 100000; // linear scan beyond this takes too long
+
+static volatile long long g_sink = 0;
+
+int main() {
+    QTextStream out(stdout);
+    out << "entities      index ns/lookup   linear ns/lookup\n";
+
+    const int sizes[] = { 100, 1000, 10000, 100000, 1000000 };
+    for (int n : sizes) {
+        BenchEntity* items = new BenchEntity[n];
+        BenchEntity** arr = new BenchEntity*[n];
+        EntityIndex<BenchEntity> index;
+        index.reserve(n);
+
+        // ids start at an offset like the real generators (m_nextCourseId = 100 ...)
+        for (int i = 0; i < n; i++) {
+            items[i].m_id = 100 + i;
+            arr[i] = &items[i];
+            index.insert(&items[i]);
+        }
+
+        // random ids, generated up front so the timing only covers lookups
+        int* keys = new int[LOOKUPS];
+        QRandomGenerator rng(42);
+        for (int i = 0; i < LOOKUPS; i++) keys[i] = 100 + rng.bounded(n);
+
+        QElapsedTimer t;
+        t.start();
+        long long sum = 0;
+        for (int i = 0; i < LOOKUPS; i++) {
+            BenchEntity* e = index.find(keys[i]);
+            if (e) sum += e->m_id;
+        }
+        double indexNs = double(t.nsecsElapsed()) / LOOKUPS;
+        g_sink = g_sink + sum;
+
+        QString linear = "-";
+        if (n <= LINEAR_MAX_N) {
+            t.restart();
+            sum = 0;
+            for (int i = 0; i < LINEAR_LOOKUPS; i++) {
+                for (int j = 0; j < n; j++) {
+                    if (arr[j]->id() == keys[i]) { sum += arr[j]->m_id; break; }
+                }
+            }
+            linear = QString::number(double(t.nsecsElapsed()) / LINEAR_LOOKUPS, 'f', 1);
+            g_sink = g_sink + sum;
+        }
+
+        out << QString::number(n).leftJustified(14)
+            << QString::number(indexNs, 'f', 1).leftJustified(18)
+            << linear << "\n";
+        out.flush();
+
+        delete[] keys;
+        delete[] arr;
+        delete[] items;
+    }
+    return 0;
+}
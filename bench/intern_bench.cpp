@@ -0,0 +1,83 @@
+// Memory and time of per-entity QString copies vs. the StringPool on a synthetic campus.
+// Every student/enrollment/notification is built both ways; names, course titles and
+// message text repeat a lot, like on a real campus.
+// Run: ./lms_intern_bench
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "../string_pool.h"
+
+static const int COURSES = 400;
+static const int ENROLLMENTS_PER_STUDENT = 5;
+
+static const char* FIRST[] = { "Abdul", "Ali", "Ayesha", "Fatima", "Hamza", "Hassan", "Maryam", "Usman", "Zainab", "Bilal" };
+static const char* LAST[] = { "Rehman", "Khan", "Ahmed", "Malik", "Butt", "Sheikh", "Qureshi", "Raza" };
+
+// heap bytes of one QString: shared header + UTF-16 payload + terminator
+static qint64 qstringBytes(const QString& s) {
+    return s.isEmpty() ? 0 : 16 + 2 * (s.size() + 1);
+}
+
+static volatile long long g_sink = 0;
+
+int main() {
+    QTextStream out(stdout);
+    out << "students      copies KB     pool KB      copies ms    pool ms\n";
+
+    QString courseNames[COURSES];
+    for (int c = 0; c < COURSES; c++) courseNames[c] = "Course " + QString::number(c % 60) + " - CS" + QString::number(100 + c);
+
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (int n : sizes) {
+        QRandomGenerator rng(42);
+
+        // --- old layout: every entity and message owns its QString ---
+        QElapsedTimer t;
+        t.start();
+        qint64 copyBytes = 0;
+        QString* names = new QString[n];
+        for (int i = 0; i < n; i++) {
+            names[i] = QString(FIRST[rng.bounded(10)]) + " " + LAST[rng.bounded(8)];
+            copyBytes += qstringBytes(names[i]);
+            QString email = "s" + QString::number(i) + "@lms.com";
+            copyBytes += qstringBytes(email);
+            for (int e = 0; e < ENROLLMENTS_PER_STUDENT; e++) {
+                QString msg = names[i] + " enrolled in " + courseNames[rng.bounded(COURSES)];
+                copyBytes += qstringBytes(msg);
+                g_sink = g_sink + msg.size();
+            }
+        }
+        double copyMs = t.nsecsElapsed() / 1e6;
+        delete[] names;
+
+        // --- interned: one copy per distinct string, messages are template + symbols ---
+        rng.seed(42);
+        t.restart();
+        StringPool pool;
+        Symbol tmpl = pool.intern(u"%1 enrolled in %2");
+        Symbol courseSyms[COURSES];
+        for (int c = 0; c < COURSES; c++) courseSyms[c] = pool.intern(courseNames[c]);
+        qint64 symbolBytes = 0;
+        for (int i = 0; i < n; i++) {
+            Symbol name = pool.intern(QString(FIRST[rng.bounded(10)]) + " " + LAST[rng.bounded(8)]);
+            pool.intern(QString("s" + QString::number(i) + "@lms.com"));
+            symbolBytes += 2 * int(sizeof(QStringView)); // User keeps views
+            for (int e = 0; e < ENROLLMENTS_PER_STUDENT; e++) {
+                Symbol args[] = { name, courseSyms[rng.bounded(COURSES)] };
+                symbolBytes += int(sizeof(args)) + int(sizeof(tmpl));
+                g_sink = g_sink + args[0] + args[1];
+            }
+        }
+        double poolMs = t.nsecsElapsed() / 1e6;
+        // chunks + lookup table (approx. one key view + symbol + bucket per entry)
+        qint64 poolBytes = pool.bytesUsed() + qint64(pool.count()) * 32 + symbolBytes;
+
+        out << QString::number(n).leftJustified(14)
+            << QString::number(copyBytes / 1024).leftJustified(14)
+            << QString::number(poolBytes / 1024).leftJustified(13)
+            << QString::number(copyMs, 'f', 1).leftJustified(13)
+            << QString::number(poolMs, 'f', 1) << "\n";
+        out.flush();
+    }
+    return 0;
+}
@@ -0,0 +1,259 @@
+// Headless LMSSystem load generator: builds a synthetic campus (CampusGenerator), then replays a
+// weighted mix of operations and reports ops/sec and latency percentiles per
+// operation. Run before deploying to catch throughput regressions.
+// Run: ./lms_bench --students 100000 --ops 1000000
+//      ./lms_bench --journal /tmp/lms.journal     (same mix with the journal on)
+//      ./lms_bench --threads 1,2,4,8             (same mix split over N threads: lock scaling)
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include "../campus_generator.h"
+#include "../lms_system.h"
+
+enum BenchOp { OpLogin, OpEnroll, OpSubmit, OpGrade, OpRead, OP_COUNT };
+static const char* OP_NAMES[OP_COUNT] = { "login", "enroll", "submit", "grade", "read" };
+static const int DEFAULT_MIX[OP_COUNT] = { 5, 10, 30, 25, 30 }; // percent
+
+static const char* BENCH_PASSWORD = "campus"; // CampusGenerator accounts
+
+static volatile long long g_sink = 0;
+
+static User* randomUser(LMSSystem& sys, QRandomGenerator& rng) {
+    return sys.userAt(rng.bounded(sys.userCount()));
+}
+
+static Student* randomStudent(LMSSystem& sys, QRandomGenerator& rng) {
+    // students are created after the admin and faculty, so retry a few times
+    for (int tries = 0; tries < 16; tries++) {
+        Student* s = sys.asStudent(randomUser(sys, rng));
+        if (s) return s;
+    }
+    return nullptr;
+}
+
+// One operation; returns false if the system refused it (duplicate, not enrolled, ...)
+// Other bench threads may be changing the same entities: lists are read under
+// readUser()/readCourse().
+static bool runOp(BenchOp op, LMSSystem& sys, QRandomGenerator& rng) {
+    switch (op) {
+    case OpLogin: {
+        User* u = randomUser(sys, rng);
+        return sys.login(u->email(), BENCH_PASSWORD) != nullptr;
+    }
+    case OpEnroll: {
+        Student* s = randomStudent(sys, rng);
+        return s && sys.studentEnroll(s, sys.courseAt(rng.bounded(sys.courseCount()))->id());
+    }
+    case OpSubmit: {
+        Student* s = randomStudent(sys, rng);
+        if (!s) return false;
+        Course* c = sys.readUser(s, [s, &rng]() {
+            return s->enrolledCount() ? s->enrolledAt(rng.bounded(s->enrolledCount())) : nullptr;
+        });
+        if (!c) return false;
+        Assignment* a = sys.readCourse(c, [c, &rng]() {
+            return c->assignmentCount() ? c->assignmentAt(rng.bounded(c->assignmentCount())) : nullptr;
+        });
+        return a && sys.studentSubmit(s, a->id(), "/uploads/" + QString::number(s->id()) + ".zip") != nullptr;
+    }
+    case OpGrade: {
+        if (sys.submissionCount() == 0) return false;
+        Submission* sub = sys.submissionAt(rng.bounded(sys.submissionCount()));
+        Course* c = sub->assignment()->course();
+        Faculty* f = sys.readCourse(c, [c]() { return c->faculty(); });
+        return sys.facultyGradeSubmission(f, sub->id(), float(rng.bounded(101)));
+    }
+    case OpRead: {
+        // newest page of one inbox, as the dashboard shows it
+        User* u = randomUser(sys, rng);
+        long long chars = sys.readUser(u, [u]() {
+            const Inbox& in = u->inbox();
+            long long n = 0;
+            for (int i = qMax(0, in.count() - LIST_PAGE_SIZE); i < in.count(); i++) n += in.at(i)->message().size();
+            return n;
+        });
+        g_sink = g_sink + chars;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+static double percentileUs(const qint64* sorted, int n, double p) {
+    if (n == 0) return 0.0;
+    int rank = qBound(1, int(p * n + 0.999999), n);
+    return sorted[rank - 1] / 1000.0;
+}
+
+// What one replay thread measured
+struct Replay {
+    GrowArray<qint64> latency[OP_COUNT];
+    int refused[OP_COUNT] = {};
+};
+
+static void replay(LMSSystem& sys, const int* mix, int mixTotal, int ops, QRandomGenerator& rng, Replay& r) {
+    for (int k = 0; k < OP_COUNT; k++) r.latency[k].reserve(ops * mix[k] / mixTotal + 16);
+
+    QElapsedTimer opTimer;
+    for (int i = 0; i < ops; i++) {
+        int pick = rng.bounded(mixTotal);
+        int k = 0;
+        while (pick >= mix[k]) pick -= mix[k++];
+
+        opTimer.start();
+        bool ok = runOp(BenchOp(k), sys, rng);
+        r.latency[k].append(opTimer.nsecsElapsed());
+        if (!ok) r.refused[k]++;
+    }
+}
+
+// Splits ops over `threads` threads (one RNG stream each) and prints the per-op
+// table; returns overall ops/s.
+static double runReplay(LMSSystem& sys, const int* mix, int mixTotal, int ops, quint32 seed, int threads, QTextStream& out) {
+    Replay* runs = new Replay[threads];
+    QRandomGenerator* rngs = new QRandomGenerator[threads];
+    QThread** workers = new QThread*[threads];
+
+    QElapsedTimer wall;
+    wall.start();
+    for (int t = 0; t < threads; t++) {
+        quint32 seeds[] = { seed, quint32(threads), quint32(t) };
+        rngs[t] = QRandomGenerator(seeds, 3);
+        int share = ops / threads + (t < ops % threads ? 1 : 0);
+        workers[t] = QThread::create([&sys, mix, mixTotal, share, rngs, runs, t]() {
+            replay(sys, mix, mixTotal, share, rngs[t], runs[t]);
+        });
+        workers[t]->start();
+    }
+    for (int t = 0; t < threads; t++) {
+        workers[t]->wait();
+        delete workers[t];
+    }
+    double wallSecs = wall.nsecsElapsed() / 1e9;
+
+    out << "\nthreads: " << threads
+        << "\nop        count     refused   ops/s        p50 us    p90 us    p99 us    max us\n";
+    for (int k = 0; k < OP_COUNT; k++) {
+        // merge the threads' samples
+        GrowArray<qint64> all;
+        int refused = 0;
+        for (int t = 0; t < threads; t++) {
+            all.reserve(all.count() + runs[t].latency[k].count());
+            for (int i = 0; i < runs[t].latency[k].count(); i++) all.append(runs[t].latency[k][i]);
+            refused += runs[t].refused[k];
+        }
+        int n = all.count();
+        qint64* d = all.data();
+        std::sort(d, d + n);
+        qint64 total = 0;
+        for (int i = 0; i < n; i++) total += d[i];
+
+        // per-op throughput of one thread; the total line below is across all
+        out << QString(OP_NAMES[k]).leftJustified(10)
+            << QString::number(n).leftJustified(10)
+            << QString::number(refused).leftJustified(10)
+            << QString::number(total ? n / (total / 1e9) : 0.0, 'f', 0).leftJustified(13)
+            << QString::number(percentileUs(d, n, 0.50), 'f', 1).leftJustified(10)
+            << QString::number(percentileUs(d, n, 0.90), 'f', 1).leftJustified(10)
+            << QString::number(percentileUs(d, n, 0.99), 'f', 1).leftJustified(10)
+            << QString::number(n ? d[n - 1] / 1000.0 : 0.0, 'f', 1) << "\n";
+    }
+    double opsPerSec = ops / wallSecs;
+    out << "total: " << ops << " ops in " << QString::number(wallSecs, 'f', 2) << " s, "
+        << QString::number(opsPerSec, 'f', 0) << " ops/s\n";
+    out.flush();
+
+    delete[] workers;
+    delete[] rngs;
+    delete[] runs;
+    return opsPerSec;
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser args;
+    args.setApplicationDescription("LMSSystem throughput and latency benchmark");
+    args.addHelpOption();
+    args.addOption(QCommandLineOption("students", "Students", "n", "10000"));
+    args.addOption(QCommandLineOption("faculty", "Faculty (default students/50)", "n"));
+    args.addOption(QCommandLineOption("courses", "Courses (default students/40)", "n"));
+    args.addOption(QCommandLineOption("enroll", "Enrollments per student", "n", "5"));
+    args.addOption(QCommandLineOption("assignments", "Assignments per course", "n", "4"));
+    args.addOption(QCommandLineOption("ops", "Operations to replay (per thread count)", "n", "200000"));
+    args.addOption(QCommandLineOption("mix", "Percent per op: login,enroll,submit,grade,read", "list", "5,10,30,25,30"));
+    args.addOption(QCommandLineOption("threads", "Replay threads, one run per entry (e.g. 1,2,4,8)", "list", "1"));
+    args.addOption(QCommandLineOption("skew", "Zipf exponent of course popularity", "s", "1.0"));
+    args.addOption(QCommandLineOption("seed", "Random seed", "n", "42"));
+    args.addOption(QCommandLineOption("hash-iterations", "PBKDF2 iterations of the bench accounts", "n", "1000"));
+    args.addOption(QCommandLineOption("journal", "Write-ahead journal file (off by default)", "path"));
+    args.process(app);
+
+    CampusSpec spec;
+    spec.students = args.value("students").toInt();
+    spec.faculty = args.value("faculty").toInt(); // unset: 0, derived
+    spec.courses = args.value("courses").toInt();
+    spec.enrollPerStudent = args.value("enroll").toInt();
+    spec.assignmentsPerCourse = args.value("assignments").toInt();
+    spec.courseSkew = args.value("skew").toDouble();
+    spec.seed = quint32(args.value("seed").toUInt());
+    spec.hashIterations = qMax(1, args.value("hash-iterations").toInt());
+    int ops = qMax(1, args.value("ops").toInt());
+
+    int mix[OP_COUNT];
+    QStringList parts = args.value("mix").split(',');
+    int mixTotal = 0;
+    for (int k = 0; k < OP_COUNT; k++) {
+        mix[k] = k < parts.size() ? qMax(0, parts[k].toInt()) : DEFAULT_MIX[k];
+        mixTotal += mix[k];
+    }
+    if (mixTotal == 0) {
+        QTextStream(stderr) << "--mix needs at least one non-zero weight\n";
+        return 1;
+    }
+
+    QStringList threadList = args.value("threads").split(',');
+    GrowArray<int> threadCounts;
+    for (int i = 0; i < threadList.size(); i++) {
+        int n = threadList[i].toInt();
+        if (n > 0) threadCounts.append(n);
+    }
+    if (threadCounts.count() == 0) {
+        QTextStream(stderr) << "--threads needs at least one positive count\n";
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    LMSSystem sys;
+
+    if (args.isSet("journal")) {
+        QString path = args.value("journal");
+        QFile::remove(path);
+        if (!sys.openJournal(path, path + ".snapshot")) {
+            QTextStream(stderr) << "cannot open journal " << path << "\n";
+            return 1;
+        }
+    }
+
+    CampusGenerator campus(spec);
+    out << "campus: " << campus.generate(sys).summary() << "\n";
+
+    // ---- replay, once per thread count (each run continues on the state the last one left) ----
+    GrowArray<double> rates;
+    for (int i = 0; i < threadCounts.count(); i++)
+        rates.append(runReplay(sys, mix, mixTotal, ops, spec.seed, threadCounts[i], out));
+
+    if (threadCounts.count() > 1) {
+        out << "\nthreads   ops/s        speedup\n";
+        for (int i = 0; i < threadCounts.count(); i++)
+            out << QString::number(threadCounts[i]).leftJustified(10)
+                << QString::number(rates[i], 'f', 0).leftJustified(13)
+                << QString::number(rates[i] / rates[0], 'f', 2) << "x\n";
+    }
+    return 0;
+}
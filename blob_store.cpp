@@ -0,0 +1,290 @@
+#include "blob_store.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+static const int SHA256_HEX_CHARS = 64;
+
+static void syncFile(QFile& f) {
+#ifdef Q_OS_WIN
+    _commit(f.handle());
+#else
+    ::fsync(f.handle());
+#endif
+}
+
+// marks the blob as used now (maintain() compresses what stays untouched)
+static void touch(const QString& path) {
+    QFile f(path);
+    if (f.open(QIODevice::ReadWrite)) f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+}
+
+// Makes dst share src's extents (reflink) where the file system can: no data
+// is copied. False if it cannot, or the platform has no such call.
+static bool cloneContent(QFile& src, QFile& dst) {
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    return ::ioctl(dst.handle(), FICLONE, src.handle()) == 0;
+#else
+    Q_UNUSED(src);
+    Q_UNUSED(dst);
+    return false;
+#endif
+}
+
+BlobStore::BlobStore() : m_bytesWritten(0), m_bytesDeduped(0), m_stopMaintenance(false) {}
+
+void BlobStore::open(const QString& dir) {
+    QMutexLocker lock(&m_lock);
+    m_dir = dir;
+}
+
+QString BlobStore::dir() const {
+    QMutexLocker lock(&m_lock);
+    return m_dir;
+}
+
+QString BlobStore::blobPath(const QString& dir, const QByteArray& sha256, bool compressed) {
+    QString hex = QString::fromLatin1(sha256.toHex());
+    return dir + "/" + hex.left(2) + "/" + hex + (compressed ? ".z" : "");
+}
+
+bool BlobStore::put(const QString& sourcePath, IngestedFile& out, QString* error,
+    const std::function<bool(qint64, qint64)>& progress) {
+    auto fail = [error](const QString& why) {
+        if (error) *error = why;
+        return false;
+    };
+
+    QString root = dir();
+    if (root.isEmpty()) return fail("the submission store is not open");
+
+    QFile src(sourcePath);
+    if (!src.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+        return fail("cannot read " + sourcePath + ": " + src.errorString());
+    QFileInfo before(sourcePath); // checked again after the copy
+
+    qint64 total = src.size();
+    auto report = [&progress, total](qint64 done) { return !progress || progress(done, total); };
+
+    // one pass: hashed while it is copied into incoming/; the copy is dropped
+    // again if that content turns out to be stored already
+    QString incoming = root + "/incoming";
+    if (!QDir().mkpath(incoming)) return fail("cannot create " + incoming);
+    QTemporaryFile tmp(incoming + "/XXXXXX.part"); // removed again unless renamed into place
+    if (!tmp.open()) return fail("cannot write to " + incoming + ": " + tmp.errorString());
+
+    // a clone shares the data, which is then only read by the hash
+    bool cloned = cloneContent(src, tmp);
+    QFile& reader = cloned ? static_cast<QFile&>(tmp) : src;
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QByteArray block(INGEST_CHUNK_BYTES, Qt::Uninitialized);
+    qint64 size = 0;
+    for (;;) {
+        qint64 n = reader.read(block.data(), block.size());
+        if (n < 0) return fail("read error in " + sourcePath + ": " + reader.errorString());
+        if (n == 0) break;
+        hash.addData(QByteArrayView(block.constData(), n));
+        if (!cloned && tmp.write(block.constData(), n) != n)
+            return fail("cannot copy " + sourcePath + ": " + tmp.errorString());
+        size += n;
+        if (!report(qMin(size, total))) return fail("cancelled");
+    }
+    if (size != total) return fail(sourcePath + " changed while it was read");
+
+    out.sha256 = hash.result();
+    out.size = size;
+    QString raw = blobPath(root, out.sha256, false);
+    QString packed = blobPath(root, out.sha256, true);
+
+    // under m_lock: maintain() must not delete a blob between this check and the touch
+    {
+        QMutexLocker lock(&m_lock);
+        bool hasRaw = QFile::exists(raw);
+        if (hasRaw || QFile::exists(packed)) {
+            out.storedPath = hasRaw ? raw : packed;
+            out.deduplicated = true;
+            touch(out.storedPath);
+            lock.unlock();
+            m_bytesDeduped += size;
+            return true;
+        }
+    }
+
+    // new content: rename the copy into place
+    if (!tmp.flush()) return fail("write error: " + tmp.errorString());
+    syncFile(tmp); // the journal will point at this blob: it must be on disk first
+
+    // the hash is only the blob's name if the file did not change in between
+    QFileInfo after(sourcePath);
+    if (after.size() != before.size() || after.lastModified() != before.lastModified() || tmp.size() != size)
+        return fail(sourcePath + " changed while it was stored");
+
+    QString shard = root + "/" + QString::fromLatin1(out.sha256.toHex().left(2));
+    if (!QDir().mkpath(shard)) return fail("cannot create " + shard);
+    out.storedPath = raw;
+    QMutexLocker lock(&m_lock);
+    if (!tmp.rename(raw)) {
+        if (!QFile::exists(raw) && !QFile::exists(packed))
+            return fail("cannot store " + raw + ": " + tmp.errorString());
+        touch(raw); // lost a race to an identical upload: fine
+        out.deduplicated = true;
+        lock.unlock();
+        m_bytesDeduped += size;
+        return true;
+    }
+    lock.unlock();
+    m_bytesWritten += size;
+    return true;
+}
+
+void BlobStore::addRef(const QByteArray& sha256, qint64 size) {
+    QMutexLocker lock(&m_lock);
+    Entry& e = m_entries[sha256];
+    e.refs++;
+    e.size = size;
+}
+
+int BlobStore::refCount(const QByteArray& sha256) const {
+    QMutexLocker lock(&m_lock);
+    auto it = m_entries.constFind(sha256);
+    return it == m_entries.constEnd() ? 0 : it.value().refs;
+}
+
+QIODevice* BlobStore::read(const QByteArray& sha256) const {
+    QString root = dir();
+    if (root.isEmpty() || sha256.isEmpty()) return nullptr;
+
+    // raw first: a blob being compressed has both forms until the raw one goes
+    QFile* raw = new QFile(blobPath(root, sha256, false));
+    if (raw->open(QIODevice::ReadOnly)) return raw;
+    delete raw;
+
+    QFile packed(blobPath(root, sha256, true));
+    if (!packed.open(QIODevice::ReadOnly)) return nullptr;
+    QByteArray data = qUncompress(packed.readAll());
+    if (data.isEmpty()) return nullptr; // damaged (empty blobs are never compressed)
+    QBuffer* buf = new QBuffer();
+    buf->setData(data);
+    buf->open(QIODevice::ReadOnly);
+    return buf;
+}
+
+BlobStore::Usage BlobStore::usage() const {
+    Usage u;
+    {
+        QMutexLocker lock(&m_lock);
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            u.blobs++;
+            u.refs += it.value().refs;
+            u.logicalBytes += it.value().size * it.value().refs;
+            u.uniqueBytes += it.value().size;
+        }
+    }
+    u.bytesWritten = m_bytesWritten;
+    u.bytesDeduped = m_bytesDeduped;
+    return u;
+}
+
+qint64 BlobStore::compress(const QString& dir, const QString& rawPath, qint64 size) {
+    QFile f(rawPath);
+    if (!f.open(QIODevice::ReadOnly)) return 0;
+    QByteArray packed = qCompress(f.readAll());
+    f.close();
+
+    // already compressed formats (pdf, zip, images) gain nothing: leave them
+    // raw and mark them used, so the next maintain() does not try again soon
+    if (packed.size() > size - size * BLOB_COMPRESS_MIN_SAVING_PCT / 100) {
+        touch(rawPath);
+        return 0;
+    }
+
+    QTemporaryFile tmp(dir + "/incoming/XXXXXX.part");
+    if (!QDir().mkpath(dir + "/incoming") || !tmp.open()) return 0;
+    if (tmp.write(packed) != packed.size() || !tmp.flush()) return 0;
+    syncFile(tmp);
+
+    // the compressed copy is complete before the raw one goes: readers always find one
+    QMutexLocker lock(&m_lock);
+    if (!tmp.rename(rawPath + ".z")) return 0;
+    QFile::remove(rawPath); // fails on Windows while a reader has it open; next run retries
+    return size - packed.size();
+}
+
+BlobStore::Maintenance BlobStore::maintain(qint64 coldAfterSecs) {
+    Maintenance m;
+    QString root = dir();
+    if (root.isEmpty()) return m;
+
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    const QStringList shards = QDir(root).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& shard : shards) {
+        if (shard == "incoming") {
+            // leftovers of uploads that crashed mid-copy
+            const QFileInfoList parts = QDir(root + "/" + shard).entryInfoList(QDir::Files);
+            for (const QFileInfo& fi : parts)
+                if (fi.lastModified().secsTo(now) > BLOB_GC_GRACE_SECS && QFile::remove(fi.filePath()))
+                    m.bytesFreed += fi.size();
+            continue;
+        }
+        if (shard.size() != 2) continue;
+
+        const QFileInfoList files = QDir(root + "/" + shard).entryInfoList(QDir::Files);
+        for (const QFileInfo& listed : files) {
+            if (m_stopMaintenance) return m;
+
+            QString name = listed.fileName();
+            bool compressed = name.endsWith(".z");
+            if (name.size() != SHA256_HEX_CHARS + (compressed ? 2 : 0)) continue;
+            QByteArray key = QByteArray::fromHex(name.left(SHA256_HEX_CHARS).toLatin1());
+
+            bool cold;
+            {
+                QMutexLocker lock(&m_lock);
+                QFileInfo fi(listed.filePath()); // fresh: put() may just have touched it
+                if (!fi.exists()) continue;
+                qint64 age = fi.lastModified().secsTo(now);
+
+                // nothing refers to it, and it is too old to be an upload awaiting its submission
+                if (!m_entries.contains(key) && age > BLOB_GC_GRACE_SECS) {
+                    if (QFile::remove(fi.filePath())) {
+                        m.removed++;
+                        m.bytesFreed += fi.size();
+                    }
+                    continue;
+                }
+                // both forms: an earlier compress() could not remove the raw one
+                if (compressed) {
+                    QString raw = fi.filePath().chopped(2);
+                    qint64 rawSize = QFileInfo(raw).size();
+                    if (QFile::exists(raw) && QFile::remove(raw)) m.bytesFreed += rawSize;
+                    continue;
+                }
+                cold = age > coldAfterSecs && fi.size() > 0 && fi.size() <= BLOB_COMPRESS_MAX_BYTES
+                    && !QFile::exists(fi.filePath() + ".z");
+            }
+            if (cold) {
+                qint64 saved = compress(root, listed.filePath(), listed.size());
+                if (saved > 0) {
+                    m.compressed++;
+                    m.bytesFreed += saved;
+                }
+            }
+        }
+    }
+    return m;
+}
+
+void BlobStore::stopMaintenance() { m_stopMaintenance = true; }
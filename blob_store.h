@@ -0,0 +1,92 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QMetaType>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <functional>
+#include "constants.h"
+
+// A submission file put into the blob store.
+struct IngestedFile {
+    QString storedPath;
+    QByteArray sha256; // raw digest of the content (the blob key)
+    qint64 size = 0;
+    bool deduplicated = false; // the content was already stored: nothing written
+};
+Q_DECLARE_METATYPE(IngestedFile)
+
+// Content-addressed store for submission files: one blob per distinct
+// content, named by its SHA-256 (<dir>/ab/abcdef..., ".z" when compressed).
+//
+// put() reads the source once, hashing it while it is copied into incoming/,
+// and drops the copy when the blob exists, so a section submitting the same
+// starter template stores one copy. The copy is a reflink where the file
+// system offers one (Linux), else streamed in INGEST_CHUNK_BYTES blocks.
+//
+// Reference counts are not stored: they are rebuilt from the submissions
+// (snapshot + journal) through addRef(). maintain() deletes unreferenced
+// blobs and compresses cold ones; open() reads either form.
+//
+// All methods are thread-safe.
+class BlobStore {
+    struct Entry {
+        int refs;
+        qint64 size;
+    };
+
+    mutable QMutex m_lock; // m_dir, m_entries
+    QString m_dir;
+    QHash<QByteArray, Entry> m_entries; // by raw sha256
+
+    std::atomic<qint64> m_bytesWritten; // since open, by put()
+    std::atomic<qint64> m_bytesDeduped; // since open, not kept because already stored
+    std::atomic<bool> m_stopMaintenance;
+
+    static QString blobPath(const QString& dir, const QByteArray& sha256, bool compressed);
+    qint64 compress(const QString& dir, const QString& rawPath, qint64 size); // bytes saved
+
+public:
+    BlobStore();
+
+    BlobStore(const BlobStore&) = delete;
+    BlobStore& operator=(const BlobStore&) = delete;
+
+    void open(const QString& dir); // created on first put()
+    QString dir() const;
+
+    // Copies sourcePath into the store. `progress` (optional) gets (bytes
+    // done, total) and may return false to abort.
+    bool put(const QString& sourcePath, IngestedFile& out, QString* error = nullptr,
+        const std::function<bool(qint64, qint64)>& progress = {});
+
+    // One more submission refers to the blob.
+    void addRef(const QByteArray& sha256, qint64 size);
+    int refCount(const QByteArray& sha256) const;
+
+    // Blob content, decompressed if needed; nullptr if it is not stored.
+    // The caller deletes the device.
+    QIODevice* read(const QByteArray& sha256) const;
+
+    struct Usage {
+        int blobs = 0;           // distinct referenced contents
+        qint64 refs = 0;         // submissions pointing at them
+        qint64 logicalBytes = 0; // what one copy per submission would take
+        qint64 uniqueBytes = 0;  // one copy per content (before compression)
+        qint64 bytesWritten = 0;
+        qint64 bytesDeduped = 0;
+    };
+    Usage usage() const;
+
+    struct Maintenance {
+        int removed = 0;    // unreferenced, older than BLOB_GC_GRACE_SECS
+        int compressed = 0; // untouched for coldAfterSecs
+        qint64 bytesFreed = 0;
+    };
+    // Walks the store; slow on big stores, run it off the GUI thread.
+    // stopMaintenance() makes it return at the next file (for shutdown).
+    Maintenance maintain(qint64 coldAfterSecs = BLOB_COLD_SECS);
+    void stopMaintenance();
+};
@@ -0,0 +1,227 @@
+#include "campus_generator.h"
+#include "lms_system.h"
+#include <QDate>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+static const char* FIRST[] = { "Abdul", "Ali", "Ayesha", "Fatima", "Hamza", "Hassan", "Maryam", "Usman",
+    "Zainab", "Bilal", "Sana", "Omar", "Hira", "Saad", "Iqra", "Talha" };
+static const char* LAST[] = { "Rehman", "Khan", "Ahmed", "Malik", "Butt", "Sheikh", "Qureshi", "Raza",
+    "Chaudhry", "Siddiqui", "Javed", "Iqbal" };
+static const char* SUBJECTS[] = { "OOP", "Data Structures", "Algorithms", "Databases", "Operating Systems",
+    "Networks", "Calculus", "Linear Algebra", "Physics", "Software Engineering", "Compilers", "AI" };
+
+static const int TERM_WEEKS = 15;
+static const int PEAK_WEEKS[] = { 7, 14 }; // midterm and final
+
+template<typename T, int N>
+static int countOf(T (&)[N]) { return N; }
+
+// ----------------- CampusReport -----------------
+QString CampusReport::summary() const {
+    return QString("%1 students, %2 faculty, %3 courses, %4 enrollments, %5 assignments, "
+                   "%6 submissions (%7 graded); plan %8 ms, apply %9 ms")
+        .arg(students).arg(faculty).arg(courses).arg(enrollments).arg(assignments)
+        .arg(submissions).arg(graded).arg(planMs).arg(applyMs);
+}
+
+// ----------------- CampusGenerator -----------------
+CampusGenerator::CampusGenerator(const CampusSpec& spec)
+    : m_spec(spec), m_courseCdf(nullptr), m_courseIds(nullptr), m_assignmentIds(nullptr)
+{
+    m_spec.students = qMax(1, m_spec.students);
+    if (m_spec.faculty <= 0) m_spec.faculty = qMax(1, m_spec.students / 50);
+    if (m_spec.courses <= 0) m_spec.courses = qMax(1, m_spec.students / 40);
+    m_spec.enrollPerStudent = qBound(0, m_spec.enrollPerStudent, m_spec.courses);
+    m_spec.assignmentsPerCourse = qMax(0, m_spec.assignmentsPerCourse);
+
+    // rank r (0 = hottest) has weight 1 / (r + 1)^skew
+    m_courseCdf = new double[m_spec.courses];
+    double total = 0.0;
+    for (int r = 0; r < m_spec.courses; r++) {
+        total += 1.0 / std::pow(r + 1.0, m_spec.courseSkew);
+        m_courseCdf[r] = total;
+    }
+    for (int r = 0; r < m_spec.courses; r++) m_courseCdf[r] /= total;
+}
+
+CampusGenerator::~CampusGenerator() {
+    delete[] m_courseCdf;
+    delete[] m_courseIds;
+    delete[] m_assignmentIds;
+}
+
+int CampusGenerator::pickCourse(QRandomGenerator& rng) const {
+    double u = rng.generateDouble();
+    const double* hit = std::upper_bound(m_courseCdf, m_courseCdf + m_spec.courses, u);
+    return qMin(int(hit - m_courseCdf), m_spec.courses - 1);
+}
+
+// Worker thread: only reads the spec and the tables built by buildStaff().
+void CampusGenerator::planChunk(Chunk* c) const {
+    const quint32 seeds[] = { m_spec.seed, quint32(c->index) };
+    QRandomGenerator rng(seeds, 2);
+    int k = m_spec.enrollPerStudent;
+
+    c->names = new QString[c->count];
+    c->courses = new int[qMax(1, c->count * k)];
+
+    for (int i = 0; i < c->count; i++) {
+        c->names[i] = QString(FIRST[rng.bounded(countOf(FIRST))]) + " " + LAST[rng.bounded(countOf(LAST))];
+
+        // k distinct courses, hot ones first in line; give up on Zipf after a few
+        // collisions (strong skew, few courses) and take the next free course
+        int* mine = c->courses + i * k;
+        for (int e = 0; e < k; e++) {
+            int course = pickCourse(rng);
+            for (int tries = 0; std::find(mine, mine + e, course) != mine + e; tries++)
+                course = tries < 8 ? pickCourse(rng) : (course + 1) % m_spec.courses;
+            mine[e] = course;
+        }
+
+        bool heavy = rng.generateDouble() < m_spec.heavySubmitterShare;
+        double rate = heavy ? m_spec.heavySubmitRate : m_spec.submitRate;
+        for (int e = 0; e < k; e++) {
+            for (int a = 0; a < m_spec.assignmentsPerCourse; a++) {
+                if (rng.generateDouble() >= rate) continue;
+                float grade = GRADE_NONE;
+                if (rng.generateDouble() < m_spec.gradedShare) {
+                    // roughly bell-shaped around 70, clipped to 0..100
+                    double g = 70.0 + 15.0 * (rng.generateDouble() + rng.generateDouble() + rng.generateDouble() - 1.5) * 2.0;
+                    grade = float(qBound(0, int(g), 100));
+                }
+                c->submissions.append(PlannedSubmission{ i, mine[e], a, grade });
+            }
+        }
+    }
+}
+
+void CampusGenerator::buildStaff(LMSSystem& sys) {
+    QRandomGenerator rng(m_spec.seed);
+
+    Admin* admin = sys.createAdmin("Campus Admin", "admin@campus.lms", m_pass);
+
+    Faculty** faculty = new Faculty*[m_spec.faculty];
+    for (int i = 0; i < m_spec.faculty; i++) {
+        QString name = QString("Dr. ") + LAST[rng.bounded(countOf(LAST))] + " " + QString::number(i);
+        faculty[i] = sys.createFaculty(name, "f" + QString::number(i) + "@campus.lms", m_pass);
+    }
+
+    m_courseIds = new int[m_spec.courses];
+    m_assignmentIds = new int[qMax(1, m_spec.courses * m_spec.assignmentsPerCourse)];
+    QDate termStart(2025, 2, 3);
+    for (int i = 0; i < m_spec.courses; i++) {
+        QString name = QString(SUBJECTS[i % countOf(SUBJECTS)]) + " - CS" + QString::number(100 + i);
+        Course* c = sys.adminCreateCourse(admin, name);
+        sys.adminAssignFaculty(admin, c->id(), faculty[i % m_spec.faculty]);
+        m_courseIds[i] = c->id();
+
+        for (int a = 0; a < m_spec.assignmentsPerCourse; a++) {
+            // bursty deadlines: most work is due in the same two weeks
+            int week = rng.generateDouble() < m_spec.deadlinePeakShare
+                ? PEAK_WEEKS[rng.bounded(countOf(PEAK_WEEKS))] : 1 + rng.bounded(TERM_WEEKS);
+            QString due = termStart.addDays(week * 7 - 3 + rng.bounded(3)).toString("yyyy-MM-dd");
+            Assignment* as = sys.facultyCreateAssignment(c->faculty(), c->id(),
+                "Assignment " + QString::number(a + 1), "Generated", due);
+            m_assignmentIds[i * m_spec.assignmentsPerCourse + a] = as->id();
+        }
+    }
+    delete[] faculty;
+
+    m_report.faculty = m_spec.faculty;
+    m_report.courses = m_spec.courses;
+    m_report.assignments = m_spec.courses * m_spec.assignmentsPerCourse;
+}
+
+// GUI/owner thread, chunks in order.
+void CampusGenerator::applyChunk(LMSSystem& sys, Chunk* c) {
+    int k = m_spec.enrollPerStudent;
+    Student** students = new Student*[c->count];
+    for (int i = 0; i < c->count; i++) {
+        QString email = "s" + QString::number(c->firstStudent + i) + "@campus.lms";
+        Student* s = sys.createStudent(c->names[i], email, m_pass);
+        students[i] = s;
+        if (!s) continue;
+        m_report.students++;
+        for (int e = 0; e < k; e++)
+            if (sys.studentEnroll(s, m_courseIds[c->courses[i * k + e]])) m_report.enrollments++;
+    }
+
+    // grades go in per faculty as one batch: one notice per student, not per grade
+    QHash<Faculty*, GrowArray<GradeEntry>*> grades;
+    GrowArray<Faculty*> graders;
+    for (int i = 0; i < c->submissions.count(); i++) {
+        const PlannedSubmission& p = c->submissions[i];
+        Student* s = students[p.student];
+        if (!s) continue;
+        Submission* sub = sys.studentSubmit(s, m_assignmentIds[p.course * m_spec.assignmentsPerCourse + p.assignment],
+            "/uploads/" + QString::number(s->studentId()) + "/a" + QString::number(p.assignment + 1) + ".zip");
+        if (!sub) continue;
+        m_report.submissions++;
+        if (p.grade < 0.0f) continue;
+
+        Faculty* f = sub->assignment()->course()->faculty();
+        if (!grades.contains(f)) {
+            grades.insert(f, new GrowArray<GradeEntry>());
+            graders.append(f);
+        }
+        grades.value(f)->append(GradeEntry{ sub->id(), p.grade });
+    }
+    for (int i = 0; i < graders.count(); i++) {
+        GrowArray<GradeEntry>* g = grades.value(graders[i]);
+        m_report.graded += sys.facultyGradeBatch(graders[i], g->data(), g->count());
+        delete g;
+    }
+    delete[] students;
+
+    delete[] c->names;
+    delete[] c->courses;
+    c->names = nullptr;
+    c->courses = nullptr;
+    c->submissions.clear();
+}
+
+CampusReport CampusGenerator::generate(LMSSystem& sys) {
+    m_report = CampusReport();
+    QElapsedTimer t;
+    t.start();
+    qint64 planNs = 0;
+
+    m_pass = PasswordHasher::make("campus", m_spec.hashIterations);
+
+    sys.beginBulk();
+    buildStaff(sys);
+
+    int chunkCount = (m_spec.students + CAMPUS_CHUNK_STUDENTS - 1) / CAMPUS_CHUNK_STUDENTS;
+    int threads = qMax(1, QThread::idealThreadCount());
+    Chunk* chunks = new Chunk[threads];
+    Chunk* window[64];
+    int windowSize = qMin(threads, 64);
+
+    for (int first = 0; first < chunkCount; first += windowSize) {
+        int n = qMin(windowSize, chunkCount - first);
+        for (int w = 0; w < n; w++) {
+            Chunk* c = &chunks[w];
+            c->index = first + w;
+            c->firstStudent = c->index * CAMPUS_CHUNK_STUDENTS;
+            c->count = qMin(CAMPUS_CHUNK_STUDENTS, m_spec.students - c->firstStudent);
+            window[w] = c;
+        }
+
+        QElapsedTimer p;
+        p.start();
+        QtConcurrent::blockingMap(window, window + n, [this](Chunk*& c) { planChunk(c); });
+        planNs += p.nsecsElapsed();
+
+        for (int w = 0; w < n; w++) applyChunk(sys, window[w]);
+    }
+    delete[] chunks;
+    sys.endBulk();
+
+    m_report.planMs = planNs / 1000000;
+    m_report.applyMs = t.elapsed() - m_report.planMs;
+    return m_report;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <QRandomGenerator>
+#include <QString>
+#include "arena.h"
+#include "auth.h"
+
+class LMSSystem;
+
+// Shape of a synthetic campus. Zero faculty/courses derive from the student count.
+struct CampusSpec {
+    int students = 1000;
+    int faculty = 0;              // 0: students / 50
+    int courses = 0;              // 0: students / 40
+    int enrollPerStudent = 5;
+    int assignmentsPerCourse = 4;
+
+    double courseSkew = 1.0;          // Zipf exponent of course popularity (0 = uniform)
+    double heavySubmitterShare = 0.2; // students who hand in nearly everything...
+    double heavySubmitRate = 0.95;
+    double submitRate = 0.5;          // ...and everyone else
+    double deadlinePeakShare = 0.6;   // assignments due in the midterm/final weeks
+    double gradedShare = 0.7;         // submissions already graded
+
+    quint32 seed = 42;
+    int hashIterations = 1000; // one password record shared by every account
+};
+
+struct CampusReport {
+    int students = 0;
+    int faculty = 0;
+    int courses = 0;
+    int enrollments = 0;
+    int assignments = 0;
+    int submissions = 0;
+    int graded = 0;
+    qint64 planMs = 0;  // parallel part
+    qint64 applyMs = 0; // LMSSystem calls
+
+    QString summary() const;
+};
+
+// Deterministic campus generator for sizing tests and benchmarks.
+// The same spec and seed always give the same campus, whatever the core count:
+// students are planned in fixed CAMPUS_CHUNK_STUDENTS chunks, each with its own
+// RNG seeded from (seed, chunk). A window of chunks (one per core) is planned in
+// parallel, then applied to LMSSystem in order inside one bulk change.
+// Skew: courses are picked by Zipf rank (a few hot courses), a share of students
+// submits almost everything, and most due dates fall into two peak weeks.
+class CampusGenerator {
+    struct PlannedSubmission {
+        int student; // within the chunk
+        int course;
+        int assignment; // within the course
+        float grade;    // GRADE_NONE: not graded yet
+    };
+
+    struct Chunk {
+        int index;
+        int firstStudent;
+        int count;
+        QString* names;
+        int* courses; // count * enrollPerStudent, -1 where the student has fewer
+        GrowArray<PlannedSubmission> submissions;
+    };
+
+    CampusSpec m_spec;
+    double* m_courseCdf; // Zipf CDF over course ranks
+    int* m_courseIds;
+    int* m_assignmentIds; // courses * assignmentsPerCourse
+    PasswordRecord m_pass;
+    CampusReport m_report;
+
+    int pickCourse(QRandomGenerator& rng) const;
+    void planChunk(Chunk* c) const;
+    void applyChunk(LMSSystem& sys, Chunk* c);
+    void buildStaff(LMSSystem& sys);
+
+public:
+    explicit CampusGenerator(const CampusSpec& spec);
+    ~CampusGenerator();
+
+    CampusGenerator(const CampusGenerator&) = delete;
+    CampusGenerator& operator=(const CampusGenerator&) = delete;
+
+    CampusReport generate(LMSSystem& sys); // call on an empty system
+};
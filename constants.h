@@ -1,15 +1,94 @@
-
 #pragma once
 
-static const int MAX_USERS = 60;
-static const int MAX_COURSES = 30;
-static const int MAX_STUDENTS = 60;
-static const int MAX_ASSIGNMENTS = 40;
-static const int MAX_SUBMISSIONS = 200;
-static const int MAX_NOTIFS = 400;
-
-static const int MAX_COURSE_STUDENTS = 60;
-static const int MAX_COURSE_ASSIGNMENTS = 30;
-static const int MAX_ASSIGN_SUBMISSIONS = 60;
-static const int MAX_STUDENT_COURSES = 10;
-static const int MAX_FACULTY_COURSES = 10;
+// Storage: entities live in slab arenas that grow on demand (see arena.h).
+// There is no fixed ceiling on users, courses, assignments, submissions or notifications.
+static const int ARENA_SLAB_SIZE = 256; // objects per slab
+
+// Concurrency: lock stripes for per-course / per-user state and id indexes (<= 64)
+static const int LOCK_SHARDS = 64;
+
+// Interned strings: UTF-16 chars per shared chunk (see string_pool.h)
+static const int STRING_POOL_CHUNK_CHARS = 16384;
+static const int NOTIF_MAX_ARGS = 3; // placeholders %1..%3 in message templates
+
+// UI: rows fetched per page by the lazy list models
+static const int LIST_PAGE_SIZE = 200;
+
+// Persistence: snapshot + write-ahead journal in the app data directory
+static const char* const SNAPSHOT_FILE_NAME = "lms.snapshot";
+static const char* const JOURNAL_FILE_NAME = "lms.journal";
+static const char* const STORE_LOCK_FILE_NAME = "lms.lock"; // one process per store (GUI or service)
+static const int JOURNAL_GROUP_COMMIT_MS = 20;      // records within this window share one write
+static const int JOURNAL_GROUP_BYTES = 64 * 1024;   // ...unless the group gets this big first
+static const int JOURNAL_FSYNC_INTERVAL_MS = 1000;  // FsyncPolicy::Interval
+static const int JOURNAL_CHECKPOINT_BYTES = 16 * 1024 * 1024; // snapshot + fresh journal past this
+
+// Notification delivery thread (see LMSSystem::deliveryLoop)
+static const int DELIVERY_BATCH_JOBS = 256;   // queued deliveries written per pass
+static const int DELIVERY_IDLE_WAIT_MS = 100; // idle wake-up, in case a signal is missed
+
+// Submission file ingestion (see submission_ingest.h, blob_store.h)
+static const char* const SUBMISSION_STORE_DIR_NAME = "submissions"; // under the app data directory
+static const int INGEST_CHUNK_BYTES = 1024 * 1024; // streamed, hashed and written per block
+static const int INGEST_MAX_PARALLEL = 4;          // files streaming at once, the rest queue
+static const int INGEST_PROGRESS_MS = 100;         // progress signal at most this often per file
+
+// Submission blob store (see blob_store.h)
+static const int BLOB_GC_GRACE_SECS = 24 * 3600;       // unreferenced blobs this young may be an upload in flight
+static const int BLOB_COLD_SECS = 30 * 24 * 3600;      // untouched this long: compressed by maintain()
+static const qint64 BLOB_COMPRESS_MAX_BYTES = 64 * 1024 * 1024; // compressed in memory; bigger blobs stay raw
+static const int BLOB_COMPRESS_MIN_SAVING_PCT = 10;    // keep the compressed copy only if this much smaller
+
+// Similarity check (see similarity.h)
+static const int SIM_KGRAM = 24;       // normalized characters per shingle
+static const int SIM_WINNOW = 16;      // shingles per window: any shared run of KGRAM+WINNOW-1 chars is caught
+static const int SIM_LSH_BANDS = 42;   // MinHash sketch = BANDS * ROWS values; pairs near
+static const int SIM_LSH_ROWS = 3;     // (1/BANDS)^(1/ROWS) ~ 0.29 Jaccard start to collide
+static const int SIM_MINHASH = SIM_LSH_BANDS * SIM_LSH_ROWS;
+static const int SIM_COMMON_PCT = 50;       // fingerprints in more files than this are boilerplate (starter code)
+static const int SIM_COMMON_MIN_FILES = 8;  // ...only judged with at least this many distinct files
+static const int SIM_MAX_FILE_BYTES = 8 * 1024 * 1024; // read per file
+static const float SIM_REPORT_MIN = 0.4f;   // Jaccard of fingerprints worth showing
+static const int SIM_MAX_REPORTED_PAIRS = 500;
+
+// Search boxes (see search_index.h)
+static const int SEARCH_MAX_HITS = 50;          // shown per query
+static const int SEARCH_MAX_SCANNED = 20000;    // postings of the rarest query token examined, newest first
+static const int SEARCH_MAX_PREFIX_TERMS = 64;  // terms one prefix token expands to
+static const int SEARCH_MAX_QUERY_TOKENS = 8;
+static const int SEARCH_WEIGHT_TITLE = 3;       // course name, assignment title
+static const int SEARCH_WEIGHT_BODY = 1;        // assignment description, notification text
+
+// Type-ahead pickers (see prefix_trie.h, entity_picker.h)
+static const int PICK_MAX_COMPLETIONS = 10; // suggestions shown per keystroke
+
+// Deadline reminders (see timer_wheel.h, LMSSystem::reminderLoop)
+static const int TIMER_WHEEL_SLOTS = 64;  // per level
+static const int TIMER_WHEEL_LEVELS = 4;  // 1-minute ticks: 64 min, ~68 h, ~182 days, ~31 years
+static const qint64 REMINDER_TICK_MS = 60 * 1000;
+static const int REMINDER_COUNT = 2;
+static const int REMINDER_HOURS_BEFORE[REMINDER_COUNT] = { 48, 2 }; // to students who have not submitted
+
+// Bulk CSV import
+static const int CSV_IMPORT_CHUNK_BYTES = 256 * 1024; // parsed in parallel, one block per core
+static const int IMPORT_MAX_REPORTED_ERRORS = 20;
+
+// Synthetic campus generator: students planned per parallel chunk
+static const int CAMPUS_CHUNK_STUDENTS = 4096;
+
+// Gradebook statistics (see gradebook.h)
+static const float GRADE_NONE = -1.0f;       // grade column value of an ungraded submission
+static const int GRADE_HISTOGRAM_BUCKETS = 10; // 0-9, 10-19, ..., 90-100
+static const int GRADE_BINS = 1001;          // 0.1-point bins over 0..100, used for percentiles
+
+// Headless service (BahriaLMS --serve): JSON over HTTP/1.1 on localhost
+static const int SERVICE_DEFAULT_PORT = 8080;
+static const int SERVICE_MAX_HEADER_BYTES = 16 * 1024;
+static const int SERVICE_MAX_BODY_BYTES = 1024 * 1024;
+static const int SERVICE_TOKEN_BYTES = 16; // bearer tokens handed out by /login
+static const int SERVICE_TOKEN_TTL_SECS = 8 * 3600; // then the client logs in again
+
+// Auth
+static const int PASSWORD_HASH_ITERATIONS = 100000;
+static const int PASSWORD_SALT_BYTES = 16;
+static const int SESSION_CACHE_TTL_SECS = 300;
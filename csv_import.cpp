@@ -0,0 +1,377 @@
+#include "csv_import.h"
+#include "lms_system.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+
+static const int MAX_FIELDS = 6;
+
+static bool looksLikeEmail(const QString& e) {
+    int at = e.indexOf('@');
+    return at > 0 && at < e.size() - 1 && !e.contains(' ');
+}
+
+// Index just past the last line end that is not inside quotes (0 if none);
+// *lines = number of line ends before it.
+static qsizetype cutPoint(const QByteArray& buf, int* lines) {
+    bool inQuotes = false;
+    qsizetype cut = 0;
+    int n = 0, atCut = 0;
+    for (qsizetype i = 0; i < buf.size(); i++) {
+        char ch = buf[i];
+        if (ch == '"') inQuotes = !inQuotes;
+        else if (ch == '\n') {
+            n++;
+            if (!inQuotes) { cut = i + 1; atCut = n; }
+        }
+    }
+    *lines = atCut;
+    return cut;
+}
+
+// ----------------- ImportReport -----------------
+double ImportReport::rowsPerSecond() const {
+    qint64 ms = parseMs + commitMs;
+    return ms > 0 ? rows * 1000.0 / ms : rows;
+}
+
+QString ImportReport::summary() const {
+    QString s = QString("%1 rows in %2 ms (%3 rows/s; parse+hash %4 ms, commit %5 ms)\n")
+        .arg(rows).arg(parseMs + commitMs).arg(qRound(rowsPerSecond())).arg(parseMs).arg(commitMs);
+    if (grades > 0 || users + courses + enrollments == 0)
+        s += QString("Grades: %1, rejected: %2").arg(grades).arg(rejected);
+    else
+        s += QString("Users: %1, courses: %2, faculty assigned: %3, enrollments: %4, rejected: %5")
+            .arg(users).arg(courses).arg(facultyAssigned).arg(enrollments).arg(rejected);
+    if (!errors.isEmpty()) s += "\n\n" + errors;
+    return s;
+}
+
+// ----------------- CsvImporter -----------------
+CsvImporter::CsvImporter(int hashIterations) : m_hashIterations(hashIterations) {
+}
+
+CsvImporter::~CsvImporter() {
+    for (int i = 0; i < m_chunks.count(); i++) {
+        delete[] m_chunks[i]->rows;
+        delete m_chunks[i];
+    }
+}
+
+// One record (may span lines inside quotes); p ends up at the next record.
+static int splitCsvRecord(const char*& p, const char* end, QString* fields, int maxFields, int* lines) {
+    int n = 0;
+    QByteArray cur;
+    bool inQuotes = false;
+
+    auto store = [&]() {
+        if (n < maxFields) fields[n] = QString::fromUtf8(cur).trimmed();
+        n++;
+        cur.clear();
+    };
+
+    while (p < end) {
+        char ch = *p++;
+        if (inQuotes) {
+            if (ch == '"') {
+                if (p < end && *p == '"') { cur += '"'; p++; }
+                else inQuotes = false;
+            } else {
+                if (ch == '\n') (*lines)++;
+                cur += ch;
+            }
+        } else if (ch == '"') {
+            inQuotes = true;
+        } else if (ch == ',') {
+            store();
+        } else if (ch == '\n') {
+            (*lines)++;
+            break;
+        } else if (ch != '\r') {
+            cur += ch;
+        }
+    }
+    store();
+    return n;
+}
+
+void CsvImporter::validate(ImportRow& row, const QString* f, int n) {
+    QString type = f[0].toLower();
+
+    if (type == "user") {
+        if (n != 5) { row.error = "user rows need 5 fields"; return; }
+        QString role = f[1].toLower();
+        if (role == "student") row.role = Role::Student;
+        else if (role == "faculty") row.role = Role::Faculty;
+        else if (role == "admin") row.role = Role::Admin;
+        else { row.error = "unknown role '" + f[1] + "'"; return; }
+        if (f[2].isEmpty()) { row.error = "empty name"; return; }
+        if (!looksLikeEmail(f[3])) { row.error = "bad email '" + f[3] + "'"; return; }
+        if (f[4].isEmpty()) { row.error = "empty password"; return; }
+        row.name = f[2];
+        row.email = f[3];
+        row.password = f[4];
+        row.kind = ImportRow::User;
+    } else if (type == "course") {
+        if (n < 2 || n > 3) { row.error = "course rows need 2 or 3 fields"; return; }
+        if (f[1].isEmpty()) { row.error = "empty course name"; return; }
+        if (n == 3 && !f[2].isEmpty() && !looksLikeEmail(f[2])) { row.error = "bad faculty email '" + f[2] + "'"; return; }
+        row.name = f[1];
+        if (n == 3) row.ref = f[2];
+        row.kind = ImportRow::Course;
+    } else if (type == "enroll") {
+        if (n != 3) { row.error = "enroll rows need 3 fields"; return; }
+        if (!looksLikeEmail(f[1])) { row.error = "bad student email '" + f[1] + "'"; return; }
+        if (f[2].isEmpty()) { row.error = "empty course name"; return; }
+        row.email = f[1];
+        row.ref = f[2];
+        row.kind = ImportRow::Enroll;
+    } else {
+        row.error = "unknown row type '" + f[0] + "'";
+    }
+}
+
+void CsvImporter::parseChunk(Chunk* c) {
+    c->rows = new ImportRow[c->lineCount + 1];
+    c->rowCount = 0;
+
+    QString fields[MAX_FIELDS];
+    const char* p = c->text.constData();
+    const char* end = p + c->text.size();
+    int line = c->firstLine;
+
+    while (p < end) {
+        int start = line;
+        int consumed = 0;
+        int n = splitCsvRecord(p, end, fields, MAX_FIELDS, &consumed);
+        line += consumed;
+
+        if (n == 1 && fields[0].isEmpty()) continue;   // blank line
+        if (fields[0].startsWith('#')) continue;         // comment
+        if (start == 1 && fields[0].toLower() == "type") continue; // header
+
+        ImportRow& row = c->rows[c->rowCount++];
+        row.line = start;
+        validate(row, fields, n);
+    }
+    c->text = QByteArray(); // rows own their text now
+}
+
+void CsvImporter::processWindow(Chunk** window, int n) {
+    // parse + validate, one block per core
+    QtConcurrent::blockingMap(window, window + n, [](Chunk*& c) { parseChunk(c); });
+
+    // password hashing, spread row by row
+    int iterations = m_hashIterations;
+    for (int i = 0; i < n; i++) {
+        Chunk* c = window[i];
+        QtConcurrent::blockingMap(c->rows, c->rows + c->rowCount, [iterations](ImportRow& row) {
+            if (row.kind != ImportRow::User) return;
+            row.pass = PasswordHasher::make(row.password, iterations);
+            row.password.clear();
+        });
+        m_report.rows += c->rowCount;
+        m_chunks.append(c);
+    }
+}
+
+bool CsvImporter::parse(const QString& path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QElapsedTimer t;
+    t.start();
+
+    int threads = qMax(1, QThread::idealThreadCount());
+    Chunk** window = new Chunk*[threads];
+    int inWindow = 0;
+    int nextLine = 1;
+    QByteArray carry;
+
+    // stream the file: only one window of raw text is in memory at a time
+    bool eof = false;
+    while (!eof) {
+        QByteArray block = f.read(CSV_IMPORT_CHUNK_BYTES);
+        eof = block.isEmpty();
+        QByteArray buf = carry + block;
+
+        int lines = 0;
+        qsizetype cut = cutPoint(buf, &lines);
+        if (eof) cut = buf.size(); // the last line may have no line end
+        if (cut > 0) {
+            Chunk* c = new Chunk;
+            c->text = buf.left(cut);
+            c->firstLine = nextLine;
+            c->lineCount = lines;
+            c->rows = nullptr;
+            c->rowCount = 0;
+            nextLine += lines;
+            window[inWindow++] = c;
+        }
+        carry = buf.mid(cut);
+
+        if (inWindow == threads || (eof && inWindow > 0)) {
+            processWindow(window, inWindow);
+            inWindow = 0;
+        }
+    }
+    delete[] window;
+
+    m_report.parseMs = t.elapsed();
+    return true;
+}
+
+void CsvImporter::reject(const ImportRow& row, const QString& why) {
+    if (m_report.rejected++ < IMPORT_MAX_REPORTED_ERRORS)
+        m_report.errors += "line " + QString::number(row.line) + ": " + why + "\n";
+}
+
+ImportReport CsvImporter::commit(LMSSystem& sys, Admin* admin) {
+    if (!admin) {
+        m_report.errors += "only an admin can import\n";
+        return m_report;
+    }
+
+    QElapsedTimer t;
+    t.start();
+    sys.beginBulk();
+
+    // 1) users
+    for (int i = 0; i < m_chunks.count(); i++) {
+        Chunk* c = m_chunks[i];
+        for (int j = 0; j < c->rowCount; j++) {
+            ImportRow& row = c->rows[j];
+            if (row.kind == ImportRow::Invalid) { reject(row, row.error); continue; }
+            if (row.kind != ImportRow::User) continue;
+
+            User* u = nullptr;
+            if (row.role == Role::Student) u = sys.createStudent(row.name, row.email, row.pass);
+            else if (row.role == Role::Faculty) u = sys.createFaculty(row.name, row.email, row.pass);
+            else u = sys.createAdmin(row.name, row.email, row.pass);
+
+            if (u) m_report.users++;
+            else reject(row, "email already in use: " + row.email);
+        }
+    }
+
+    // 2) courses (existing ones are reused by name, so re-importing is harmless)
+    QHash<QString, Course*> byName;
+    byName.reserve(sys.courseCount());
+    for (int i = 0; i < sys.courseCount(); i++) byName.insert(sys.courseAt(i)->name(), sys.courseAt(i));
+
+    for (int i = 0; i < m_chunks.count(); i++) {
+        Chunk* c = m_chunks[i];
+        for (int j = 0; j < c->rowCount; j++) {
+            ImportRow& row = c->rows[j];
+            if (row.kind != ImportRow::Course) continue;
+
+            Course* course = byName.value(row.name, nullptr);
+            if (!course) {
+                course = sys.adminCreateCourse(admin, row.name);
+                byName.insert(row.name, course);
+                m_report.courses++;
+            }
+            if (row.ref.isEmpty()) continue;
+
+            Faculty* f = sys.asFaculty(sys.findUserByEmail(row.ref));
+            if (!f) reject(row, "no faculty with email " + row.ref);
+            else if (course->faculty() != f && sys.adminAssignFaculty(admin, course->id(), f)) m_report.facultyAssigned++;
+        }
+    }
+
+    // 3) enrollments
+    for (int i = 0; i < m_chunks.count(); i++) {
+        Chunk* c = m_chunks[i];
+        for (int j = 0; j < c->rowCount; j++) {
+            ImportRow& row = c->rows[j];
+            if (row.kind != ImportRow::Enroll) continue;
+
+            Student* s = sys.asStudent(sys.findUserByEmail(row.email));
+            Course* course = byName.value(row.ref, nullptr);
+            if (!s) reject(row, "no student with email " + row.email);
+            else if (!course) reject(row, "no course named " + row.ref);
+            else if (sys.studentEnroll(s, course->id())) m_report.enrollments++;
+            else reject(row, row.email + " is already enrolled in " + row.ref);
+        }
+    }
+
+    sys.endBulk();
+    m_report.commitMs = t.elapsed();
+    return m_report;
+}
+
+// ----------------- GradebookImporter -----------------
+void GradebookImporter::reject(int line, const QString& why) {
+    if (m_report.rejected++ < IMPORT_MAX_REPORTED_ERRORS)
+        m_report.errors += "line " + QString::number(line) + ": " + why + "\n";
+}
+
+bool GradebookImporter::parse(const LMSSystem& sys, const QString& path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QElapsedTimer t;
+    t.start();
+
+    QString fields[MAX_FIELDS];
+    int line = 0;
+    while (!f.atEnd()) {
+        QByteArray raw = f.readLine();
+        line++;
+        const char* p = raw.constData();
+        int consumed = 0;
+        int n = splitCsvRecord(p, p + raw.size(), fields, MAX_FIELDS, &consumed);
+
+        if (n == 1 && fields[0].isEmpty()) continue;
+        if (fields[0].startsWith('#')) continue;
+        m_report.rows++;
+
+        bool okGrade = false;
+        float grade = fields[qMin(n, MAX_FIELDS) - 1].toFloat(&okGrade);
+        if (n < 2 || n > 3 || !okGrade || grade < 0.0f || grade > 100.0f) {
+            // a "submission,grade" style header is not worth an error
+            if (line == 1) m_report.rows--;
+            else reject(line, "expected <submission id>,<grade> or <email>,<assignment id>,<grade> with a grade 0-100");
+            continue;
+        }
+
+        int subId = -1;
+        if (n == 2) {
+            bool okId = false;
+            subId = fields[0].toInt(&okId);
+            if (!okId) { reject(line, "bad submission id '" + fields[0] + "'"); continue; }
+        } else {
+            bool okId = false;
+            int assignmentId = fields[1].toInt(&okId);
+            Assignment* a = okId ? sys.findAssignmentById(assignmentId) : nullptr;
+            Student* s = sys.asStudent(sys.findUserByEmail(fields[0]));
+            if (!a) { reject(line, "no assignment " + fields[1]); continue; }
+            if (!s) { reject(line, "no student with email " + fields[0]); continue; }
+            Submission* sub = sys.findSubmission(s, a);
+            if (!sub) { reject(line, fields[0] + " has no submission for assignment " + fields[1]); continue; }
+            subId = sub->id();
+        }
+        m_entries.append(GradeEntry{ subId, grade });
+    }
+    m_report.parseMs = t.elapsed();
+    return true;
+}
+
+ImportReport GradebookImporter::commit(LMSSystem& sys, Faculty* faculty) {
+    if (!faculty) {
+        m_report.errors += "only a faculty member can import grades\n";
+        return m_report;
+    }
+
+    QElapsedTimer t;
+    t.start();
+    m_report.grades = sys.facultyGradeBatch(faculty, m_entries.data(), m_entries.count());
+    int skipped = m_entries.count() - m_report.grades;
+    if (skipped > 0) {
+        m_report.rejected += skipped;
+        m_report.errors += QString::number(skipped) + " row(s) refer to unknown submissions or courses you do not teach\n";
+    }
+    m_report.commitMs = t.elapsed();
+    return m_report;
+}
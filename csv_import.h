@@ -0,0 +1,102 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include "arena.h"
+#include "auth.h"
+#include "lms_system.h"
+
+// Registrar bulk import.
+//
+// One row per line, first field says what it is ('#' lines and a leading
+// "type,..." header are skipped; fields may be "quoted", "" is a quote):
+//   user,<student|faculty|admin>,<name>,<email>,<password>
+//   course,<name>,<faculty email (optional)>
+//   enroll,<student email>,<course name>
+//
+// Pipeline:
+// 1) parse() (worker thread): the file is read in CSV_IMPORT_CHUNK_BYTES
+//    blocks cut at line ends; each window of blocks (one per core) is parsed
+//    and validated in parallel, then the window's passwords are hashed in
+//    parallel row by row (hashing is by far the slowest part).
+// 2) commit() (GUI thread): all rows go into LMSSystem as one bulk change
+//    (users, then courses, then enrollments), so rows may refer to entities
+//    defined further down the file. One bulkImported() signal, no per-row
+//    notifications.
+
+struct ImportRow {
+    enum Kind { Invalid, User, Course, Enroll };
+
+    Kind kind = Invalid;
+    Role role = Role::Student;
+    int line = 0;
+    QString name;  // user name / course name
+    QString email; // user email / student email (enroll)
+    QString ref;   // course: faculty email, enroll: course name
+    QString password; // plaintext until hashed into pass, then cleared
+    PasswordRecord pass;
+    QString error; // why the row is Invalid
+};
+
+struct ImportReport {
+    int rows = 0;
+    int users = 0;
+    int courses = 0;
+    int facultyAssigned = 0;
+    int enrollments = 0;
+    int grades = 0;
+    int rejected = 0;
+    QString errors; // first IMPORT_MAX_REPORTED_ERRORS problems, one per line
+    qint64 parseMs = 0;
+    qint64 commitMs = 0;
+
+    double rowsPerSecond() const;
+    QString summary() const;
+};
+
+class CsvImporter {
+    struct Chunk {
+        QByteArray text;
+        int firstLine;
+        int lineCount;
+        ImportRow* rows;
+        int rowCount;
+    };
+
+    GrowArray<Chunk*> m_chunks;
+    ImportReport m_report;
+    int m_hashIterations;
+
+    static void parseChunk(Chunk* c);
+    static void validate(ImportRow& row, const QString* f, int n);
+    void processWindow(Chunk** window, int n);
+
+    void reject(const ImportRow& row, const QString& why);
+
+public:
+    explicit CsvImporter(int hashIterations = PASSWORD_HASH_ITERATIONS);
+    ~CsvImporter();
+
+    CsvImporter(const CsvImporter&) = delete;
+    CsvImporter& operator=(const CsvImporter&) = delete;
+
+    bool parse(const QString& path); // false if the file cannot be read
+    ImportReport commit(LMSSystem& sys, Admin* admin);
+};
+
+// Faculty gradebook import (spreadsheet export), one grade per line:
+//   <submission id>,<grade>
+//   <student email>,<assignment id>,<grade>
+// parse() streams the file line by line into a compact GradeEntry list (only
+// lookups: may run on a worker); commit() applies it with a single
+// LMSSystem::facultyGradeBatch, so each student gets one notification however
+// many of their submissions are in the file.
+class GradebookImporter {
+    GrowArray<GradeEntry> m_entries;
+    ImportReport m_report;
+
+    void reject(int line, const QString& why);
+
+public:
+    bool parse(const LMSSystem& sys, const QString& path); // false if the file cannot be read
+    ImportReport commit(LMSSystem& sys, Faculty* faculty);
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <QHash>
+#include <QReadWriteLock>
+#include "constants.h"
+
+// Id -> entity lookup table.
+// LMSSystem keeps one of these per entity type and updates it on every
+// insert/remove, so lookups by id are O(1) instead of a scan over the storage.
+// T only needs an `int id() const`.
+// Split into LOCK_SHARDS tables by id, each behind its own read/write lock:
+// lookups from many threads only share a lock with inserts into the same shard.
+template<typename T>
+class EntityIndex {
+    struct Shard {
+        mutable QReadWriteLock lock;
+        QHash<int, T*> byId;
+    };
+
+    Shard m_shards[LOCK_SHARDS];
+
+    Shard& shard(int id) { return m_shards[quint32(id) % LOCK_SHARDS]; }
+    const Shard& shard(int id) const { return m_shards[quint32(id) % LOCK_SHARDS]; }
+
+public:
+    void reserve(int n) {
+        for (Shard& s : m_shards) {
+            QWriteLocker lock(&s.lock);
+            s.byId.reserve(n / LOCK_SHARDS + 1);
+        }
+    }
+
+    bool insert(T* e) {
+        if (!e) return false;
+        Shard& s = shard(e->id());
+        QWriteLocker lock(&s.lock);
+        if (s.byId.contains(e->id())) return false;
+        s.byId.insert(e->id(), e);
+        return true;
+    }
+
+    bool remove(T* e) {
+        if (!e) return false;
+        Shard& s = shard(e->id());
+        QWriteLocker lock(&s.lock);
+        auto it = s.byId.find(e->id());
+        if (it == s.byId.end() || it.value() != e) return false;
+        s.byId.erase(it);
+        return true;
+    }
+
+    T* find(int id) const {
+        const Shard& s = shard(id);
+        QReadLocker lock(&s.lock);
+        return s.byId.value(id, nullptr);
+    }
+
+    bool contains(int id) const {
+        const Shard& s = shard(id);
+        QReadLocker lock(&s.lock);
+        return s.byId.contains(id);
+    }
+
+    int size() const {
+        int n = 0;
+        for (const Shard& s : m_shards) {
+            QReadLocker lock(&s.lock);
+            n += int(s.byId.size());
+        }
+        return n;
+    }
+
+    void clear() {
+        for (Shard& s : m_shards) {
+            QWriteLocker lock(&s.lock);
+            s.byId.clear();
+        }
+    }
+};
+
+// (owner id, item id) -> entity, e.g. (student, assignment) -> submission.
+// Sharded by owner like EntityIndex, so one owner's lookups share a lock only
+// with inserts for owners in the same shard.
+template<typename T>
+class PairIndex {
+    struct Shard {
+        mutable QReadWriteLock lock;
+        QHash<quint64, T*> byPair;
+    };
+
+    Shard m_shards[LOCK_SHARDS];
+
+    static quint64 key(int owner, int item) { return (quint64(quint32(owner)) << 32) | quint32(item); }
+    Shard& shard(int owner) { return m_shards[quint32(owner) % LOCK_SHARDS]; }
+    const Shard& shard(int owner) const { return m_shards[quint32(owner) % LOCK_SHARDS]; }
+
+public:
+    void reserve(int n) {
+        for (Shard& s : m_shards) {
+            QWriteLocker lock(&s.lock);
+            s.byPair.reserve(n / LOCK_SHARDS + 1);
+        }
+    }
+
+    // false if the pair already has an entity
+    bool insert(int owner, int item, T* e) {
+        if (!e) return false;
+        Shard& s = shard(owner);
+        QWriteLocker lock(&s.lock);
+        auto it = s.byPair.constFind(key(owner, item));
+        if (it != s.byPair.constEnd()) return false;
+        s.byPair.insert(key(owner, item), e);
+        return true;
+    }
+
+    T* find(int owner, int item) const {
+        const Shard& s = shard(owner);
+        QReadLocker lock(&s.lock);
+        return s.byPair.value(key(owner, item), nullptr);
+    }
+
+    bool contains(int owner, int item) const { return find(owner, item) != nullptr; }
+};
@@ -0,0 +1,68 @@
+#include "entity_picker.h"
+#include <QAbstractItemView>
+
+EntityPicker::EntityPicker(LMSSystem& sys, PickKind kind, QWidget* parent)
+    : QLineEdit(parent), m_sys(sys), m_kind(kind), m_model(new PickListModel(sys, kind, this)),
+    m_completer(new QCompleter(this)), m_id(-1)
+{
+    setPlaceholderText(kind == PickKind::Course ? "Type a course number or name..." : "Type a name or email...");
+    setClearButtonEnabled(true);
+
+    // the model already holds just the matches: the completer must not filter again
+    m_completer->setModel(m_model);
+    m_completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    m_completer->setCaseSensitivity(Qt::CaseInsensitive);
+    m_completer->setMaxVisibleItems(PICK_MAX_COMPLETIONS);
+    m_completer->setWidget(this);
+
+    connect(this, &QLineEdit::textEdited, this, &EntityPicker::suggest);
+    connect(m_completer, qOverload<const QModelIndex&>(&QCompleter::activated), this,
+        [this](const QModelIndex& index) { pick(index.data(Qt::UserRole).toInt()); });
+    connect(this, &QLineEdit::returnPressed, this, [this]() {
+        if (m_id < 0 && m_model->rowCount() > 0) pick(m_model->idAt(0));
+    });
+}
+
+void EntityPicker::suggest(const QString& text)
+{
+    if (m_id >= 0) {
+        m_id = -1;
+        emit currentIdChanged(-1);
+    }
+
+    int ids[PICK_MAX_COMPLETIONS];
+    int n = text.trimmed().isEmpty() ? 0 : m_sys.complete(m_kind, text, ids, PICK_MAX_COMPLETIONS, m_filter);
+    m_model->setMatches(ids, n);
+    if (n > 0) m_completer->complete();
+    else m_completer->popup()->hide();
+}
+
+void EntityPicker::pick(int id)
+{
+    setText(PickListModel::label(m_sys, m_kind, id));
+    m_completer->popup()->hide();
+    if (id == m_id) return;
+    m_id = id;
+    emit currentIdChanged(id);
+}
+
+int EntityPicker::currentId() const { return m_id; }
+
+void EntityPicker::setCurrentId(int id)
+{
+    if (id < 0 || (m_filter && !m_filter(id)) || PickListModel::label(m_sys, m_kind, id).isEmpty()) {
+        m_model->setMatches(nullptr, 0);
+        clear();
+        if (m_id < 0) return;
+        m_id = -1;
+        emit currentIdChanged(-1);
+        return;
+    }
+    pick(id);
+}
+
+void EntityPicker::setFilter(const std::function<bool(int)>& f)
+{
+    m_filter = f;
+    if (m_id >= 0 && m_filter && !m_filter(m_id)) setCurrentId(-1);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <QCompleter>
+#include <QLineEdit>
+#include <functional>
+#include "list_models.h"
+
+// Type-ahead replacement for a combo box of every course / faculty member /
+// student. Each keystroke asks LMSSystem::complete() for the closest
+// PICK_MAX_COMPLETIONS matches (course id or name words; user name words or
+// email) and shows only those, so the widget stays small however many
+// entities there are. Picking a suggestion (or Return on the first one) sets
+// currentId(); editing the text again clears it.
+class EntityPicker : public QLineEdit {
+    Q_OBJECT
+
+    LMSSystem& m_sys;
+    PickKind m_kind;
+    PickListModel* m_model;
+    QCompleter* m_completer;
+    std::function<bool(int)> m_filter;
+    int m_id; // -1: nothing picked
+
+    void suggest(const QString& text);
+    void pick(int id);
+
+public:
+    EntityPicker(LMSSystem& sys, PickKind kind, QWidget* parent = nullptr);
+
+    int currentId() const;
+    void setCurrentId(int id); // -1 clears
+
+    // only ids f accepts are suggested (e.g. a faculty member's own courses)
+    void setFilter(const std::function<bool(int)>& f);
+
+signals:
+    void currentIdChanged(int id);
+};
@@ -0,0 +1,219 @@
+#include "gradebook.h"
+#include "models.h"
+#include <QtAlgorithms>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LMS_GRADE_SSE2
+#include <emmintrin.h>
+#endif
+
+// ----------------- Kernels -----------------
+void gradeMoments(const float* g, int n, GradeMoments& m) {
+    float lo = m.count ? m.min : std::numeric_limits<float>::infinity();
+    float hi = m.count ? m.max : -std::numeric_limits<float>::infinity();
+    int count = 0;
+    double sum = 0.0, sumSq = 0.0;
+    int i = 0;
+
+#ifdef LMS_GRADE_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    __m128 vmin = _mm_set1_ps(lo), vmax = _mm_set1_ps(hi);
+    __m128d sumLo = _mm_setzero_pd(), sumHi = _mm_setzero_pd();
+    __m128d sqLo = _mm_setzero_pd(), sqHi = _mm_setzero_pd();
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(g + i);
+        __m128 graded = _mm_cmpge_ps(v, zero);
+        count += qPopulationCount(quint32(_mm_movemask_ps(graded)));
+
+        __m128 x = _mm_and_ps(v, graded); // ungraded -> 0 for the sums
+        vmin = _mm_min_ps(vmin, _mm_or_ps(x, _mm_andnot_ps(graded, inf)));
+        vmax = _mm_max_ps(vmax, v); // ungraded rows are negative, never the max
+
+        // sums in double: float lanes lose whole points past ~10^5 rows
+        __m128d a = _mm_cvtps_pd(x);
+        __m128d b = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+        sumLo = _mm_add_pd(sumLo, a);
+        sumHi = _mm_add_pd(sumHi, b);
+        sqLo = _mm_add_pd(sqLo, _mm_mul_pd(a, a));
+        sqHi = _mm_add_pd(sqHi, _mm_mul_pd(b, b));
+    }
+
+    double s[2], q[2];
+    float mn[4], mx[4];
+    _mm_storeu_pd(s, _mm_add_pd(sumLo, sumHi));
+    _mm_storeu_pd(q, _mm_add_pd(sqLo, sqHi));
+    _mm_storeu_ps(mn, vmin);
+    _mm_storeu_ps(mx, vmax);
+    sum = s[0] + s[1];
+    sumSq = q[0] + q[1];
+    for (int k = 0; k < 4; k++) {
+        if (mn[k] < lo) lo = mn[k];
+        if (mx[k] > hi) hi = mx[k];
+    }
+#endif
+
+    for (; i < n; i++) {
+        float v = g[i];
+        if (v < 0.0f) continue;
+        count++;
+        sum += v;
+        sumSq += double(v) * v;
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+
+    if (m.count + count == 0) return;
+    m.count += count;
+    m.sum += sum;
+    m.sumSq += sumSq;
+    m.min = lo;
+    m.max = hi;
+}
+
+void gradeBins(const float* g, int n, quint32* bins) {
+    // bin = floor(grade * 10), 100 -> GRADE_BINS - 1; ungraded rows go to a spare slot
+    quint32 local[GRADE_BINS + 1] = {};
+    int i = 0;
+
+#ifdef LMS_GRADE_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ten = _mm_set1_ps(10.0f);
+    const __m128 top = _mm_set1_ps(float(GRADE_BINS - 1));
+    const __m128i spare = _mm_set1_epi32(GRADE_BINS);
+
+    alignas(16) qint32 idx[4];
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(g + i);
+        __m128i graded = _mm_castps_si128(_mm_cmpge_ps(v, zero));
+        __m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(v, ten), top));
+        b = _mm_or_si128(_mm_and_si128(graded, b), _mm_andnot_si128(graded, spare));
+        _mm_store_si128(reinterpret_cast<__m128i*>(idx), b);
+        local[idx[0]]++;
+        local[idx[1]]++;
+        local[idx[2]]++;
+        local[idx[3]]++;
+    }
+#endif
+
+    for (; i < n; i++) {
+        float v = g[i];
+        if (v < 0.0f) continue;
+        int b = int(v * 10.0f);
+        local[b < GRADE_BINS ? b : GRADE_BINS - 1]++;
+    }
+
+    for (int b = 0; b < GRADE_BINS; b++) bins[b] += local[b];
+}
+
+// lower edge of the bin holding the rank-th smallest grade (1-based)
+static float binValue(const quint32* bins, int rank) {
+    int seen = 0;
+    for (int b = 0; b < GRADE_BINS; b++) {
+        seen += int(bins[b]);
+        if (seen >= rank) return b / 10.0f;
+    }
+    return 100.0f;
+}
+
+GradeStats gradeStats(int submissions, const GradeMoments& m, const quint32* bins) {
+    GradeStats s;
+    s.submissions = submissions;
+    s.graded = m.count;
+    if (m.count == 0) return s;
+
+    s.mean = m.sum / m.count;
+    s.variance = qMax(0.0, m.sumSq / m.count - s.mean * s.mean);
+    s.stddev = std::sqrt(s.variance);
+    s.min = m.min;
+    s.max = m.max;
+
+    // nearest rank
+    s.p25 = binValue(bins, qMax(1, int(std::ceil(0.25 * m.count))));
+    s.median = binValue(bins, qMax(1, int(std::ceil(0.50 * m.count))));
+    s.p75 = binValue(bins, qMax(1, int(std::ceil(0.75 * m.count))));
+    s.p90 = binValue(bins, qMax(1, int(std::ceil(0.90 * m.count))));
+
+    const int perBucket = (GRADE_BINS - 1) / GRADE_HISTOGRAM_BUCKETS;
+    for (int b = 0; b < GRADE_BINS; b++)
+        s.histogram[qMin(b / perBucket, GRADE_HISTOGRAM_BUCKETS - 1)] += int(bins[b]);
+    return s;
+}
+
+// ----------------- Gradebook -----------------
+Gradebook::Gradebook() : m_rows(0) {}
+
+int Gradebook::addColumn() {
+    Column* c = m_columns.create();
+    c->assignment = m_columns.count() - 1;
+    c->graded = 0;
+    return c->assignment;
+}
+
+int Gradebook::addRow(int column, int studentUserId) {
+    Column* c = m_columns.at(column);
+    if (!c) return -1;
+    c->grades.append(GRADE_NONE);
+    c->status.append(quint8(SubmissionStatus::Submitted));
+    c->students.append(studentUserId);
+    m_rows++;
+    return c->grades.count() - 1;
+}
+
+void Gradebook::setGrade(int column, int row, float grade) {
+    Column* c = m_columns.at(column);
+    if (!c || row < 0 || row >= c->grades.count()) return;
+    if (c->grades[row] < 0.0f) c->graded++;
+    c->grades[row] = grade;
+    c->status[row] = quint8(SubmissionStatus::Graded);
+}
+
+int Gradebook::columnCount() const { return m_columns.count(); }
+int Gradebook::rowCount() const { return m_rows; }
+
+int Gradebook::rowCount(int column) const {
+    Column* c = m_columns.at(column);
+    return c ? c->grades.count() : 0;
+}
+
+int Gradebook::gradedCount(int column) const {
+    Column* c = m_columns.at(column);
+    return c ? c->graded : 0;
+}
+
+const float* Gradebook::grades(int column) const {
+    Column* c = m_columns.at(column);
+    return c ? c->grades.data() : nullptr;
+}
+
+const quint8* Gradebook::status(int column) const {
+    Column* c = m_columns.at(column);
+    return c ? c->status.data() : nullptr;
+}
+
+const qint32* Gradebook::students(int column) const {
+    Column* c = m_columns.at(column);
+    return c ? c->students.data() : nullptr;
+}
+
+GradeStats Gradebook::stats(int column) const {
+    return stats(&column, 1);
+}
+
+GradeStats Gradebook::stats(const int* columns, int n) const {
+    GradeMoments m;
+    quint32 bins[GRADE_BINS] = {};
+    int rows = 0;
+    for (int i = 0; i < n; i++) {
+        Column* c = m_columns.at(columns[i]);
+        if (!c) continue;
+        rows += c->grades.count();
+        if (c->graded == 0) continue; // nothing to scan
+        gradeMoments(c->grades.data(), c->grades.count(), m);
+        gradeBins(c->grades.data(), c->grades.count(), bins);
+    }
+    return gradeStats(rows, m, bins);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <QtGlobal>
+#include <atomic>
+#include "arena.h"
+#include "constants.h"
+
+// Grade statistics for one assignment or a whole course (graded rows only).
+// Percentiles come from 0.1-point bins, so they are exact to 0.1.
+struct GradeStats {
+    int submissions = 0; // graded or not
+    int graded = 0;
+    double mean = 0.0;
+    double variance = 0.0; // population variance
+    double stddev = 0.0;
+    float min = 0.0f;
+    float max = 0.0f;
+    float p25 = 0.0f;
+    float median = 0.0f;
+    float p75 = 0.0f;
+    float p90 = 0.0f;
+    int histogram[GRADE_HISTOGRAM_BUCKETS] = {}; // 0-9, 10-19, ..., 90-100
+};
+
+// Running sums the kernels accumulate into (several columns can feed one).
+struct GradeMoments {
+    int count = 0;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    float min = 0.0f;
+    float max = 0.0f;
+};
+
+// Kernels over a plain grade column; GRADE_NONE (ungraded) rows are skipped.
+// SSE2 when the compiler targets it, plain loops otherwise.
+void gradeMoments(const float* grades, int n, GradeMoments& m);
+void gradeBins(const float* grades, int n, quint32* bins); // adds into GRADE_BINS counters
+GradeStats gradeStats(int submissions, const GradeMoments& m, const quint32* bins);
+
+// Structure-of-arrays copy of every submission's grade, kept by LMSSystem
+// alongside the object model. One column group per assignment, rows in
+// submission order, so an assignment's grades are one contiguous float array
+// and a course is a handful of them: statistics never touch a Submission.
+// Threads: addColumn() calls are serialized by the owner; a column's rows and
+// grades are guarded by whatever guards its assignment (LMSSystem: the course lock).
+class Gradebook {
+    struct Column {
+        GrowArray<float> grades;    // GRADE_NONE until graded
+        GrowArray<quint8> status;   // SubmissionStatus
+        GrowArray<qint32> students; // student user id
+        int assignment;             // assignment index (creation order)
+        int graded;
+    };
+
+    SlabArena<Column> m_columns; // one per assignment, in creation order
+    std::atomic<int> m_rows;
+
+public:
+    Gradebook();
+
+    int addColumn();                           // new assignment -> column index
+    int addRow(int column, int studentUserId); // new submission -> row in that column
+    void setGrade(int column, int row, float grade);
+
+    int columnCount() const;
+    int rowCount() const; // all columns
+    int rowCount(int column) const;
+    int gradedCount(int column) const;
+    const float* grades(int column) const;
+    const quint8* status(int column) const;
+    const qint32* students(int column) const;
+
+    GradeStats stats(int column) const;
+    GradeStats stats(const int* columns, int n) const; // combined, e.g. a course
+};
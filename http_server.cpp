@@ -0,0 +1,184 @@
+#include "http_server.h"
+#include <QTcpSocket>
+
+static const char* statusText(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 501: return "Not Implemented";
+    default:  return "Error";
+    }
+}
+
+static void appendResponse(QByteArray& out, const HttpResponse& r, bool keepAlive) {
+    out += "HTTP/1.1 " + QByteArray::number(r.status) + " " + statusText(r.status) + "\r\n";
+    out += "Content-Type: application/json\r\n";
+    out += "Content-Length: " + QByteArray::number(r.body.size()) + "\r\n";
+    out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    out += r.body;
+}
+
+static HttpResponse errorResponse(int status, const char* message) {
+    HttpResponse r;
+    r.status = status;
+    r.body = QByteArray("{\"error\":\"") + message + "\"}";
+    return r;
+}
+
+// One client connection; lives (with its socket) in a worker thread.
+class HttpConnection : public QObject {
+    LmsService& m_service;
+    QTcpSocket* m_socket;
+    QByteArray m_in; // bytes not yet consumed (partial or pipelined requests)
+
+    // parses one request from m_in: 1 = done, 0 = need more bytes, -1 = bad (status set)
+    int parse(HttpRequest& req, int& status);
+    void onReadyRead();
+
+public:
+    HttpConnection(LmsService& service, qintptr fd, QObject* parent);
+    bool isOpen() const;
+};
+
+HttpConnection::HttpConnection(LmsService& service, qintptr fd, QObject* parent)
+    : QObject(parent), m_service(service), m_socket(new QTcpSocket(this))
+{
+    if (!m_socket->setSocketDescriptor(fd)) return;
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(m_socket, &QTcpSocket::readyRead, this, [this]() { onReadyRead(); });
+    connect(m_socket, &QTcpSocket::disconnected, this, [this]() { deleteLater(); });
+}
+
+bool HttpConnection::isOpen() const {
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+int HttpConnection::parse(HttpRequest& req, int& status) {
+    int headerEnd = m_in.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (m_in.size() <= SERVICE_MAX_HEADER_BYTES) return 0;
+        status = 431;
+        return -1;
+    }
+
+    const QList<QByteArray> lines = m_in.left(headerEnd).split('\n');
+    const QList<QByteArray> start = lines[0].trimmed().split(' ');
+    if (start.size() != 3 || !start[2].startsWith("HTTP/1.")) {
+        status = 400;
+        return -1;
+    }
+
+    req = HttpRequest();
+    req.method = start[0];
+    int q = start[1].indexOf('?');
+    req.path = q < 0 ? start[1] : start[1].left(q);
+    req.query = q < 0 ? QByteArray() : start[1].mid(q + 1);
+    req.keepAlive = start[2] != "HTTP/1.0"; // 1.1 default
+
+    qint64 length = 0;
+    for (int i = 1; i < lines.size(); i++) {
+        QByteArray line = lines[i].trimmed();
+        int colon = line.indexOf(':');
+        if (colon <= 0) continue;
+        QByteArray name = line.left(colon).trimmed().toLower();
+        QByteArray value = line.mid(colon + 1).trimmed();
+
+        if (name == "content-length") {
+            bool ok = false;
+            length = value.toLongLong(&ok);
+            if (!ok || length < 0) { status = 400; return -1; }
+        } else if (name == "connection") {
+            QByteArray v = value.toLower();
+            if (v == "close") req.keepAlive = false;
+            else if (v == "keep-alive") req.keepAlive = true;
+        } else if (name == "authorization") {
+            req.authorization = value;
+        } else if (name == "transfer-encoding") {
+            status = 501; // chunked request bodies are not supported
+            return -1;
+        }
+    }
+    if (length > SERVICE_MAX_BODY_BYTES) {
+        status = 413;
+        return -1;
+    }
+
+    qint64 total = headerEnd + 4 + length;
+    if (m_in.size() < total) return 0; // body still arriving
+    req.body = m_in.mid(headerEnd + 4, int(length));
+    m_in.remove(0, int(total));
+    return 1;
+}
+
+void HttpConnection::onReadyRead() {
+    m_in += m_socket->readAll();
+
+    // answer every complete request in the buffer (pipelining), in order
+    QByteArray out;
+    bool close = false;
+    while (!close) {
+        HttpRequest req;
+        int status = 0;
+        int r = parse(req, status);
+        if (r == 0) break;
+        if (r < 0) {
+            appendResponse(out, errorResponse(status, statusText(status)), false);
+            close = true;
+            break;
+        }
+        appendResponse(out, m_service.handle(req), req.keepAlive);
+        close = !req.keepAlive;
+    }
+
+    if (!out.isEmpty()) m_socket->write(out);
+    if (close) {
+        m_in.clear();
+        m_socket->disconnectFromHost();
+    }
+}
+
+// ----------------- HttpServer -----------------
+HttpServer::HttpServer(LmsService& service, int workerThreads, QObject* parent)
+    : QTcpServer(parent), m_service(service), m_next(0)
+{
+    for (int i = 0; i < qMax(1, workerThreads); i++) {
+        QThread* t = new QThread();
+        t->setObjectName("http-worker-" + QString::number(i));
+        QObject* worker = new QObject();
+        worker->moveToThread(t);
+        t->start();
+        m_threads.append(t);
+        m_workers.append(worker);
+    }
+}
+
+HttpServer::~HttpServer() {
+    close();
+    for (int i = 0; i < m_threads.count(); i++) {
+        // connections are children of the worker, destroyed in their own thread
+        QObject* worker = m_workers[i];
+        QMetaObject::invokeMethod(worker, [worker]() { delete worker; }, Qt::BlockingQueuedConnection);
+        m_threads[i]->quit();
+        m_threads[i]->wait();
+        delete m_threads[i];
+    }
+}
+
+void HttpServer::incomingConnection(qintptr fd) {
+    QObject* worker = m_workers[m_next];
+    m_next = (m_next + 1) % m_workers.count();
+
+    // the socket has to be created in the thread that will serve it
+    LmsService& service = m_service;
+    QMetaObject::invokeMethod(worker, [&service, fd, worker]() {
+        HttpConnection* c = new HttpConnection(service, fd, worker);
+        if (!c->isOpen()) delete c;
+    }, Qt::QueuedConnection);
+}
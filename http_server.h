@@ -0,0 +1,24 @@
+#pragma once
+#include <QTcpServer>
+#include <QThread>
+#include "arena.h"
+#include "lms_service.h"
+
+// Minimal HTTP/1.1 front end for LmsService.
+// The listening socket lives in the main thread; each accepted connection is
+// handed (round robin) to one of a fixed set of worker threads and stays there.
+// Connections are keep-alive by default and pipelined requests are answered
+// in order, all responses of one read going out in one write.
+class HttpServer : public QTcpServer {
+    LmsService& m_service;
+    GrowArray<QThread*> m_threads;
+    GrowArray<QObject*> m_workers; // one per thread: context for its connections
+    int m_next;
+
+protected:
+    void incomingConnection(qintptr fd) override;
+
+public:
+    HttpServer(LmsService& service, int workerThreads, QObject* parent = nullptr);
+    ~HttpServer(); // closes every connection and joins the workers
+};
@@ -0,0 +1,171 @@
+#include "journal.h"
+#include <QDateTime>
+#include <QThread>
+#include <cstring>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// [u32 len][u16 crc][u8 op][u8 flags][u64 seq][i64 time ms]; the CRC covers op..payload
+static const int RECORD_HEADER_BYTES = 24;
+static const int RECORD_CRC_FROM = 6;
+
+Journal::Journal()
+    : m_armed(false), m_policy(FsyncPolicy::Interval), m_lastSeq(0), m_lastSyncMs(0), m_unsynced(false)
+{
+    m_groupTimer.setSingleShot(true);
+    QObject::connect(&m_groupTimer, &QTimer::timeout, [this]() { commit(); });
+}
+
+Journal::~Journal() {
+    QMutexLocker lock(&m_lock);
+    commitLocked();
+    if (m_unsynced) sync();
+}
+
+bool Journal::open(const QString& path, quint64 afterSeq,
+    const std::function<void(JournalOp, quint8, qint64, QDataStream&)>& apply, FsyncPolicy policy)
+{
+    // not locked: runs once at startup, and replay calls back into LMSSystem
+    if (m_file.isOpen()) return false;
+    m_policy = policy;
+    m_lastSeq = afterSeq;
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) return false; // created if missing
+
+    // ---- replay everything newer than the snapshot ----
+    QByteArray data = m_file.readAll();
+    qint64 pos = 0;
+    while (pos + RECORD_HEADER_BYTES <= data.size()) {
+        const char* rec = data.constData() + pos;
+        quint32 len;
+        quint16 crc;
+        quint64 seq;
+        qint64 timeMs;
+        std::memcpy(&len, rec, 4);
+        std::memcpy(&crc, rec + 4, 2);
+        std::memcpy(&seq, rec + 8, 8);
+        std::memcpy(&timeMs, rec + 16, 8);
+
+        // torn or damaged tail: everything from here on is dropped
+        if (qint64(len) > data.size() - pos - RECORD_HEADER_BYTES) break;
+        if (qChecksum(QByteArrayView(rec + RECORD_CRC_FROM, RECORD_HEADER_BYTES - RECORD_CRC_FROM + len)) != crc) break;
+
+        if (seq > m_lastSeq) {
+            // records missing in between (e.g. an older snapshot was loaded
+            // after the journal was reset past it): replaying on would skip them
+            if (seq != m_lastSeq + 1) {
+                m_file.close();
+                return false;
+            }
+            QByteArray payload = QByteArray::fromRawData(rec + RECORD_HEADER_BYTES, len);
+            QDataStream in(payload);
+            in.setVersion(QDataStream::Qt_6_0);
+            apply(JournalOp(quint8(rec[6])), quint8(rec[7]), timeMs, in);
+            m_lastSeq = seq;
+        }
+        pos += RECORD_HEADER_BYTES + len;
+    }
+
+    if (pos < data.size()) m_file.resize(pos);
+    m_file.seek(pos);
+    m_lastSyncMs = QDateTime::currentMSecsSinceEpoch();
+    return true;
+}
+
+bool Journal::isOpen() const {
+    QMutexLocker lock(&m_lock);
+    return m_file.isOpen();
+}
+
+void Journal::append(JournalOp op, qint64 timeMs, const QByteArray& payload, quint8 flags) {
+    QMutexLocker lock(&m_lock);
+    if (!m_file.isOpen()) return;
+
+    quint32 len = quint32(payload.size());
+    quint64 seq = ++m_lastSeq;
+    char header[RECORD_HEADER_BYTES] = { 0 };
+    std::memcpy(header, &len, 4);
+    header[6] = char(op);
+    header[7] = char(flags);
+    std::memcpy(header + 8, &seq, 8);
+    std::memcpy(header + 16, &timeMs, 8);
+
+    qsizetype start = m_pending.size();
+    m_pending.append(header, RECORD_HEADER_BYTES);
+    m_pending.append(payload);
+    quint16 crc = qChecksum(QByteArrayView(m_pending.constData() + start + RECORD_CRC_FROM,
+        RECORD_HEADER_BYTES - RECORD_CRC_FROM + len));
+    std::memcpy(m_pending.data() + start + 4, &crc, 2);
+
+    if (m_pending.size() >= JOURNAL_GROUP_BYTES) commitLocked();
+    else if (!m_armed) schedule(JOURNAL_GROUP_COMMIT_MS);
+}
+
+// QTimer may only be started from its own thread
+void Journal::schedule(int ms) {
+    m_armed = true;
+    if (QThread::currentThread() == m_groupTimer.thread()) {
+        m_groupTimer.start(ms);
+        return;
+    }
+    QMetaObject::invokeMethod(&m_groupTimer, [this, ms]() { m_groupTimer.start(ms); }, Qt::QueuedConnection);
+}
+
+void Journal::commit() {
+    QMutexLocker lock(&m_lock);
+    commitLocked();
+}
+
+void Journal::commitLocked() {
+    // a timer still pending from an earlier schedule() just finds nothing to do
+    m_armed = false;
+    if (!m_file.isOpen()) return;
+
+    if (!m_pending.isEmpty()) {
+        // one write for the whole group
+        m_file.write(m_pending);
+        m_file.flush();
+        m_pending.clear();
+        m_unsynced = true;
+    }
+    if (!m_unsynced || m_policy == FsyncPolicy::Never) return;
+
+    qint64 sinceSync = QDateTime::currentMSecsSinceEpoch() - m_lastSyncMs;
+    if (m_policy == FsyncPolicy::OnCommit || sinceSync >= JOURNAL_FSYNC_INTERVAL_MS) sync();
+    else schedule(int(JOURNAL_FSYNC_INTERVAL_MS - sinceSync)); // sync the tail later
+}
+
+void Journal::sync() {
+    if (!m_file.isOpen()) return;
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    ::fsync(m_file.handle());
+#endif
+    m_unsynced = false;
+    m_lastSyncMs = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool Journal::reset() {
+    QMutexLocker lock(&m_lock);
+    if (!m_file.isOpen()) return false;
+    commitLocked();
+    if (!m_file.resize(0)) return false;
+    m_file.seek(0);
+    sync();
+    return true;
+}
+
+quint64 Journal::lastSeq() const {
+    QMutexLocker lock(&m_lock);
+    return m_lastSeq;
+}
+
+qint64 Journal::size() const {
+    QMutexLocker lock(&m_lock);
+    return m_file.size() + m_pending.size();
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QMutex>
+#include <QTimer>
+#include <functional>
+#include "constants.h"
+
+// One record per successful LMSSystem mutation.
+enum class JournalOp : quint8 {
+    CreateAdmin = 1,
+    CreateFaculty,
+    CreateStudent,
+    CreateCourse,
+    AssignFaculty,
+    Enroll,
+    Submit,
+    CreateAssignment,
+    Grade,
+    SendNotif,
+    BroadcastNotif,
+    BroadcastToCourse,
+    BulkBegin,
+    BulkEnd,
+    GradeBatch,
+    MarkRead,
+    MarkAllRead,
+    Remind,
+    MarkRangeRead
+};
+
+// Record flags (0 in records written before there were any)
+static const quint8 JOURNAL_FLAG_OUTSIDE_BULK = 1; // made by a thread not in a bulk run
+
+// When committed groups reach the disk.
+enum class FsyncPolicy {
+    Never,    // write() only, the OS flushes when it likes (survives app crashes, not power loss)
+    OnCommit, // fsync every group commit
+    Interval  // fsync at most once per JOURNAL_FSYNC_INTERVAL_MS
+};
+
+// Append-only write-ahead journal.
+// Record: [u32 payload length][u16 CRC][u8 op][u8 flags][u64 seq][i64 time ms][payload].
+// append() only buffers; the buffer is written as one group when it passes
+// JOURNAL_GROUP_BYTES or JOURNAL_GROUP_COMMIT_MS after the first record of the
+// group, so a burst of clicks costs one write (and at most one fsync).
+// A torn or damaged tail (crash mid-write) ends replay and is cut off on open.
+// append/commit may be called from any thread (service workers); the group
+// timer itself lives in the thread that created the journal.
+class Journal {
+    mutable QMutex m_lock;
+    QFile m_file;
+    QByteArray m_pending; // current group
+    QTimer m_groupTimer;
+    bool m_armed;         // a group commit is scheduled
+    FsyncPolicy m_policy;
+    quint64 m_lastSeq;
+    qint64 m_lastSyncMs;
+    bool m_unsynced; // written since the last fsync
+
+    void schedule(int ms);
+    void commitLocked();
+    void sync();
+
+public:
+    Journal();
+    ~Journal(); // commits what is buffered
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Replays records with seq > afterSeq, truncates a torn tail and opens for appending.
+    // False (nothing more applied, file left as is) if the records after afterSeq
+    // do not start at afterSeq + 1.
+    bool open(const QString& path, quint64 afterSeq,
+        const std::function<void(JournalOp, quint8 flags, qint64 timeMs, QDataStream& in)>& apply,
+        FsyncPolicy policy = FsyncPolicy::Interval);
+    bool isOpen() const;
+
+    void append(JournalOp op, qint64 timeMs, const QByteArray& payload, quint8 flags = 0);
+    void commit();
+
+    // after a checkpoint (snapshot saved with lastSeq()): start an empty journal
+    bool reset();
+
+    quint64 lastSeq() const;
+    qint64 size() const; // bytes on disk + buffered
+};
+
+// Packs arguments into a journal payload.
+template<typename... Args>
+QByteArray journalPayload(const Args&... args) {
+    QByteArray out;
+    QDataStream s(&out, QIODevice::WriteOnly);
+    s.setVersion(QDataStream::Qt_6_0);
+    (s << ... << args);
+    return out;
+}
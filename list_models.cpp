@@ -0,0 +1,188 @@
+#include "list_models.h"
+
+static QString notifLine(const Notification* n, bool read)
+{
+    return QString(read ? "  " : "* ") +
+        n->time().toString("yyyy-MM-dd hh:mm") + "  " + n->message();
+}
+
+static QString submissionItemText(const Submission* s)
+{
+    QString item = QString::number(s->id()) + " - " + s->student()->name() +
+        " -> " + s->assignment()->title();
+    if (s->status() == SubmissionStatus::Graded)
+        item += " [graded: " + QString::number(s->grade()) + "]";
+    return item;
+}
+
+// ----------------- NotificationListModel -----------------
+NotificationListModel::NotificationListModel(const LMSSystem& sys, QObject* parent)
+    : QAbstractListModel(parent), m_sys(sys), m_user(nullptr), m_known(0), m_loaded(0) {
+}
+
+void NotificationListModel::setUser(const User* u)
+{
+    beginResetModel();
+    m_user = u;
+    m_known = u ? m_sys.readUser(u, [u]() { return u->inbox().count(); }) : 0;
+    m_loaded = 0;
+    endResetModel();
+}
+
+int NotificationListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_loaded;
+}
+
+QVariant NotificationListModel::data(const QModelIndex& index, int role) const
+{
+    if (!m_user || !index.isValid() || index.row() >= m_loaded) return QVariant();
+
+    // row 0 = newest
+    int i = m_known - 1 - index.row();
+    const User* u = m_user;
+    return m_sys.readUser(u, [u, i, role]() -> QVariant {
+        const Notification* n = u->inbox().at(i);
+        if (!n) return QVariant();
+
+        if (role == Qt::DisplayRole) return notifLine(n, u->inbox().isRead(i));
+        if (role == Qt::UserRole) return n->id();
+        return QVariant();
+    });
+}
+
+bool NotificationListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_user && m_loaded < m_known;
+}
+
+void NotificationListModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) return;
+    int n = qMin(LIST_PAGE_SIZE, m_known - m_loaded);
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded + n - 1);
+    m_loaded += n;
+    endInsertRows();
+}
+
+void NotificationListModel::syncWithInbox()
+{
+    if (!m_user) return;
+    const User* u = m_user;
+    int added = m_sys.readUser(u, [u]() { return u->inbox().count(); }) - m_known;
+    if (added <= 0) return;
+
+    // newest items always sit at the top, inside the loaded window
+    beginInsertRows(QModelIndex(), 0, added - 1);
+    m_known += added;
+    m_loaded += added;
+    endInsertRows();
+}
+
+void NotificationListModel::loadedRange(int& begin, int& end) const
+{
+    begin = m_known - m_loaded;
+    end = m_known;
+}
+
+// ----------------- SubmissionListModel -----------------
+SubmissionListModel::SubmissionListModel(QObject* parent)
+    : QAbstractListModel(parent), m_faculty(nullptr), m_loaded(0) {
+}
+
+void SubmissionListModel::setFaculty(const Faculty* f)
+{
+    beginResetModel();
+    m_faculty = f;
+    m_loaded = 0;
+    endResetModel();
+}
+
+int SubmissionListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_loaded;
+}
+
+QVariant SubmissionListModel::data(const QModelIndex& index, int role) const
+{
+    if (!m_faculty || !index.isValid() || index.row() >= m_loaded) return QVariant();
+
+    const Submission* s = m_faculty->submissionAt(index.row());
+    if (!s || !s->student() || !s->assignment()) return QVariant();
+
+    if (role == Qt::DisplayRole) return submissionItemText(s);
+    if (role == Qt::UserRole) return s->id();
+    return QVariant();
+}
+
+bool SubmissionListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_faculty && m_loaded < m_faculty->submissionCount();
+}
+
+void SubmissionListModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) return;
+    int n = qMin(LIST_PAGE_SIZE, m_faculty->submissionCount() - m_loaded);
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded + n - 1);
+    m_loaded += n;
+    endInsertRows();
+}
+
+void SubmissionListModel::submissionAppended()
+{
+    if (!m_faculty) return;
+    // only show it now if everything before it is already loaded;
+    // otherwise a later fetchMore() picks it up
+    if (m_loaded != m_faculty->submissionCount() - 1) return;
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded);
+    m_loaded++;
+    endInsertRows();
+}
+
+void SubmissionListModel::submissionChanged()
+{
+    // views only repaint what is on screen, so this stays cheap at any size
+    if (m_loaded > 0) emit dataChanged(index(0), index(m_loaded - 1));
+}
+
+// ----------------- PickListModel -----------------
+PickListModel::PickListModel(const LMSSystem& sys, PickKind kind, QObject* parent)
+    : QAbstractListModel(parent), m_sys(sys), m_kind(kind), m_count(0) {
+}
+
+void PickListModel::setMatches(const int* ids, int count)
+{
+    beginResetModel();
+    m_count = qBound(0, count, PICK_MAX_COMPLETIONS);
+    for (int i = 0; i < m_count; i++) m_ids[i] = ids[i];
+    endResetModel();
+}
+
+int PickListModel::idAt(int row) const
+{
+    return row >= 0 && row < m_count ? m_ids[row] : -1;
+}
+
+int PickListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant PickListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count) return QVariant();
+    if (role == Qt::UserRole) return m_ids[index.row()];
+    if (role == Qt::DisplayRole || role == Qt::EditRole) return label(m_sys, m_kind, m_ids[index.row()]);
+    return QVariant();
+}
+
+QString PickListModel::label(const LMSSystem& sys, PickKind kind, int id)
+{
+    if (kind == PickKind::Course) {
+        const Course* c = sys.findCourseById(id);
+        return c ? QString::number(c->id()) + " - " + c->name() : QString();
+    }
+    const User* u = sys.findUserById(id);
+    return u ? u->name() + " <" + u->email() + ">" : QString();
+}
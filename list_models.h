@@ -0,0 +1,77 @@
+#pragma once
+#include <QAbstractListModel>
+#include "lms_system.h"
+
+// Lazy, paginated list models over LMSSystem data.
+// Neither model copies anything per row: data() reads straight from the
+// underlying GrowArray, rowCount() only grows as the view asks for more
+// (canFetchMore/fetchMore, LIST_PAGE_SIZE rows at a time).
+
+// One user's inbox, newest first.
+// The delivery thread appends to inboxes, so every read goes through
+// LMSSystem::readUser().
+class NotificationListModel : public QAbstractListModel {
+    Q_OBJECT
+
+    const LMSSystem& m_sys;
+    const User* m_user;
+    int m_known;  // inbox size the rows are numbered against
+    int m_loaded; // rows exposed to the view so far
+
+public:
+    explicit NotificationListModel(const LMSSystem& sys, QObject* parent = nullptr);
+
+    void setUser(const User* u); // nullptr = empty
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void syncWithInbox(); // new items arrived: insert them at the top
+    void loadedRange(int& begin, int& end) const; // inbox entries [begin, end) behind the rows
+};
+
+// A faculty member's grading queue (Faculty::submissionAt), oldest first.
+class SubmissionListModel : public QAbstractListModel {
+    Q_OBJECT
+
+    const Faculty* m_faculty;
+    int m_loaded;
+
+public:
+    explicit SubmissionListModel(QObject* parent = nullptr);
+
+    void setFaculty(const Faculty* f); // nullptr = empty
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void submissionAppended(); // newest item of the queue is new
+    void submissionChanged();  // e.g. graded; repaints the visible rows
+};
+
+// Current suggestions of a type-ahead picker (at most PICK_MAX_COMPLETIONS
+// ids, from LMSSystem::complete), labelled on demand.
+class PickListModel : public QAbstractListModel {
+    Q_OBJECT
+
+    const LMSSystem& m_sys;
+    PickKind m_kind;
+    int m_ids[PICK_MAX_COMPLETIONS];
+    int m_count;
+
+public:
+    PickListModel(const LMSSystem& sys, PickKind kind, QObject* parent = nullptr);
+
+    void setMatches(const int* ids, int count);
+    int idAt(int row) const; // -1 if out of range
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // "101 - Intro to Programming", "Dr. Ahmed <faculty@lms.com>"; empty if unknown
+    static QString label(const LMSSystem& sys, PickKind kind, int id);
+};
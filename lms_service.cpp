@@ -0,0 +1,242 @@
+#include "lms_service.h"
+#include "lms_system.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+
+static HttpResponse reply(int status, const QJsonObject& o) {
+    HttpResponse r;
+    r.status = status;
+    r.body = QJsonDocument(o).toJson(QJsonDocument::Compact);
+    return r;
+}
+
+static HttpResponse error(int status, const QString& message) {
+    return reply(status, QJsonObject{ { "error", message } });
+}
+
+static int queryInt(const QByteArray& query, const char* key, int def) {
+    const QList<QByteArray> parts = query.split('&');
+    for (const QByteArray& p : parts) {
+        int eq = p.indexOf('=');
+        if (eq > 0 && p.left(eq) == key) {
+            bool ok = false;
+            int v = p.mid(eq + 1).toInt(&ok);
+            return ok ? v : def;
+        }
+    }
+    return def;
+}
+
+static QString roleName(Role r) {
+    if (r == Role::Admin) return "admin";
+    if (r == Role::Faculty) return "faculty";
+    return "student";
+}
+
+LmsService::LmsService(LMSSystem& sys) : m_sys(sys), m_purgeAt(1024) {}
+
+// ----------------- Dispatch -----------------
+HttpResponse LmsService::handle(const HttpRequest& req) {
+    QJsonObject body;
+    if (req.method == "POST" && !req.body.isEmpty()) {
+        QJsonParseError err;
+        QJsonDocument doc = QJsonDocument::fromJson(req.body, &err);
+        if (err.error != QJsonParseError::NoError || !doc.isObject())
+            return error(400, "body must be a JSON object");
+        body = doc.object();
+    }
+
+    bool get = req.method == "GET";
+    bool post = req.method == "POST";
+    if (req.path == "/login") return post ? login(body) : error(405, "use POST");
+
+    int userId = userIdFor(req);
+    if (userId < 0) return error(401, "missing or unknown bearer token");
+
+    if (req.path == "/logout") return post ? logout(req) : error(405, "use POST");
+    if (req.path == "/courses") return get ? courses(req) : error(405, "use GET");
+    if (req.path == "/enroll") return post ? enroll(userId, body) : error(405, "use POST");
+    if (req.path == "/submit") return post ? submit(userId, body) : error(405, "use POST");
+    if (req.path == "/grade") return post ? grade(userId, body) : error(405, "use POST");
+    if (req.path == "/work") return get ? work(userId) : error(405, "use GET");
+    if (req.path == "/inbox") return get ? inbox(userId, req) : error(405, "use GET");
+    if (req.path == "/inbox/read") return post ? markRead(userId, body) : error(405, "use POST");
+    return error(404, "no such endpoint");
+}
+
+int LmsService::userIdFor(const HttpRequest& req) {
+    if (!req.authorization.startsWith("Bearer ")) return -1;
+    QByteArray token = req.authorization.mid(7).trimmed();
+    {
+        QReadLocker lock(&m_tokenLock);
+        auto it = m_tokens.constFind(token);
+        if (it == m_tokens.constEnd()) return -1;
+        if (it.value().expiresAt >= QDateTime::currentSecsSinceEpoch()) return it.value().userId;
+    }
+    QWriteLocker lock(&m_tokenLock); // expired: drop it
+    m_tokens.remove(token);
+    return -1;
+}
+
+User* LmsService::userFor(int userId) const {
+    return m_sys.findUserById(userId);
+}
+
+// ----------------- Session -----------------
+HttpResponse LmsService::login(const QJsonObject& body) {
+    QString email = body.value("email").toString();
+    QString pass = body.value("password").toString();
+
+    User* u = m_sys.login(email, pass);
+    if (!u) return error(401, "invalid email or password");
+    int userId = u->id();
+    QJsonObject out{ { "userId", userId }, { "role", roleName(u->role()) }, { "name", u->name() } };
+
+    quint32 raw[SERVICE_TOKEN_BYTES / 4];
+    QRandomGenerator::system()->fillRange(raw);
+    QByteArray token = QByteArray(reinterpret_cast<const char*>(raw), sizeof(raw)).toHex();
+    {
+        qint64 now = QDateTime::currentSecsSinceEpoch();
+        QWriteLocker lock(&m_tokenLock);
+        // tokens never used again are not looked up: sweep them (amortized)
+        if (m_tokens.size() >= m_purgeAt) {
+            for (auto it = m_tokens.begin(); it != m_tokens.end();) {
+                if (it.value().expiresAt < now) it = m_tokens.erase(it);
+                else ++it;
+            }
+            m_purgeAt = qMax(1024, int(m_tokens.size()) * 2);
+        }
+        m_tokens.insert(token, Token{ userId, now + SERVICE_TOKEN_TTL_SECS });
+    }
+    out.insert("token", QString::fromLatin1(token));
+    return reply(200, out);
+}
+
+HttpResponse LmsService::logout(const HttpRequest& req) {
+    QWriteLocker lock(&m_tokenLock);
+    m_tokens.remove(req.authorization.mid(7).trimmed());
+    return reply(200, QJsonObject{ { "ok", true } });
+}
+
+// ----------------- Queries -----------------
+HttpResponse LmsService::courses(const HttpRequest& req) {
+    int offset = qMax(0, queryInt(req.query, "offset", 0));
+    int limit = qBound(1, queryInt(req.query, "limit", LIST_PAGE_SIZE), LIST_PAGE_SIZE);
+
+    QJsonArray items;
+    int total = m_sys.courseCount();
+    int end = qMin(total, offset + limit);
+    for (int i = offset; i < end; i++) {
+        Course* c = m_sys.courseAt(i);
+        items.append(m_sys.readCourse(c, [c]() {
+            return QJsonObject{
+                { "id", c->id() },
+                { "name", c->name() },
+                { "faculty", c->faculty() ? c->faculty()->name() : QString() },
+                { "students", c->studentCount() },
+                { "assignments", c->assignmentCount() } };
+        }));
+    }
+    return reply(200, QJsonObject{ { "total", total }, { "items", items } });
+}
+
+// the student's own courses and submissions only, whatever the campus size
+HttpResponse LmsService::work(int userId) {
+    Student* s = m_sys.asStudent(userFor(userId));
+    if (!s) return error(403, "students only");
+
+    GrowArray<Assignment*> open;
+    m_sys.studentOpenAssignments(s, open);
+    QJsonArray openItems;
+    for (int i = 0; i < open.count(); i++) {
+        const Assignment* a = open[i];
+        openItems.append(QJsonObject{
+            { "id", a->id() },
+            { "title", a->title() },
+            { "courseId", a->course()->id() },
+            { "course", a->course()->name() },
+            { "due", a->dueMs() > 0 ? QDateTime::fromMSecsSinceEpoch(a->dueMs()).toUTC().toString(Qt::ISODate) : QString() } });
+    }
+
+    GrowArray<Submission*> mine;
+    m_sys.studentSubmissions(s, mine);
+    QJsonArray submitted;
+    for (int i = 0; i < mine.count(); i++) {
+        const Submission* sub = mine[i];
+        bool graded = sub->status() == SubmissionStatus::Graded;
+        submitted.append(QJsonObject{
+            { "id", sub->id() },
+            { "assignmentId", sub->assignment()->id() },
+            { "title", sub->assignment()->title() },
+            { "graded", graded },
+            { "grade", graded ? QJsonValue(double(sub->grade())) : QJsonValue() } });
+    }
+    return reply(200, QJsonObject{ { "open", openItems }, { "submissions", submitted } });
+}
+
+HttpResponse LmsService::inbox(int userId, const HttpRequest& req) {
+    User* u = userFor(userId);
+    if (!u) return error(401, "user no longer exists");
+
+    return m_sys.readUser(u, [u, &req]() {
+        const Inbox& in = u->inbox();
+        int limit = qBound(1, queryInt(req.query, "limit", LIST_PAGE_SIZE), LIST_PAGE_SIZE);
+        int offset = qBound(0, queryInt(req.query, "offset", qMax(0, in.count() - limit)), in.count());
+
+        QJsonArray items;
+        int end = qMin(in.count(), offset + limit);
+        for (int i = offset; i < end; i++) {
+            Notification* n = in.at(i);
+            items.append(QJsonObject{
+                { "index", i },
+                { "id", n->id() },
+                { "message", n->message() },
+                { "sender", n->sender() ? n->sender()->name() : QString("System") },
+                { "time", n->time().toString(Qt::ISODate) },
+                { "read", in.isRead(i) } });
+        }
+        return reply(200, QJsonObject{ { "total", in.count() }, { "unread", in.unreadCount() }, { "items", items } });
+    });
+}
+
+// ----------------- Actions -----------------
+HttpResponse LmsService::enroll(int userId, const QJsonObject& body) {
+    Student* s = m_sys.asStudent(userFor(userId));
+    if (!s) return error(403, "students only");
+    if (!m_sys.studentEnroll(s, body.value("courseId").toInt(-1)))
+        return error(409, "enroll failed (unknown course or already enrolled)");
+    return reply(200, QJsonObject{ { "ok", true } });
+}
+
+HttpResponse LmsService::submit(int userId, const QJsonObject& body) {
+    QString path = body.value("filePath").toString().trimmed();
+    if (path.isEmpty()) return error(400, "filePath required");
+
+    Student* s = m_sys.asStudent(userFor(userId));
+    if (!s) return error(403, "students only");
+    Submission* sub = m_sys.studentSubmit(s, body.value("assignmentId").toInt(-1), path);
+    if (!sub) return error(409, "submit failed (not enrolled or duplicate submission)");
+    return reply(200, QJsonObject{ { "submissionId", sub->id() } });
+}
+
+HttpResponse LmsService::grade(int userId, const QJsonObject& body) {
+    double g = body.value("grade").toDouble(-1.0);
+    if (g < 0.0 || g > 100.0) return error(400, "grade must be 0-100");
+
+    Faculty* f = m_sys.asFaculty(userFor(userId));
+    if (!f) return error(403, "faculty only");
+    if (!m_sys.facultyGradeSubmission(f, body.value("submissionId").toInt(-1), float(g)))
+        return error(409, "grade failed (unknown submission or not your course)");
+    return reply(200, QJsonObject{ { "ok", true } });
+}
+
+HttpResponse LmsService::markRead(int userId, const QJsonObject& body) {
+    User* u = userFor(userId);
+    if (!u) return error(401, "user no longer exists");
+
+    if (body.value("all").toBool()) m_sys.markAllRead(u);
+    else if (!m_sys.markRead(u, body.value("index").toInt(-1))) return error(400, "index out of range");
+    return reply(200, QJsonObject{ { "unread", m_sys.readUser(u, [u]() { return u->inbox().unreadCount(); }) } });
+}
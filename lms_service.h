@@ -0,0 +1,72 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QReadWriteLock>
+
+class LMSSystem;
+class User;
+
+struct HttpRequest {
+    QByteArray method;
+    QByteArray path;  // without the query string
+    QByteArray query; // after '?', still encoded
+    QByteArray authorization;
+    QByteArray body;
+    bool keepAlive = true;
+};
+
+struct HttpResponse {
+    int status = 200;
+    QByteArray body; // JSON
+};
+
+// JSON API over one shared LMSSystem, independent of the transport.
+// handle() may be called from any number of worker threads; they call into
+// the (thread-safe) LMSSystem directly, with no lock of their own.
+//
+//   POST /login        {"email","password"}      -> {"token","userId","role","name"}
+//   POST /logout
+//   GET  /courses?offset=&limit=
+//   POST /enroll       {"courseId"}                 (student)
+//   POST /submit       {"assignmentId","filePath"}  (student) -> {"submissionId"}
+//   POST /grade        {"submissionId","grade"}     (faculty)
+//   GET  /work                                      (student) open assignments + own submissions
+//   GET  /inbox?offset=&limit=                      newest page by default
+//   POST /inbox/read   {"index"} or {"all":true}
+//
+// Everything except /login needs "Authorization: Bearer <token>". A token
+// expires SERVICE_TOKEN_TTL_SECS after its /login.
+class LmsService {
+    LMSSystem& m_sys;
+
+    struct Token {
+        int userId;
+        qint64 expiresAt;
+    };
+
+    QReadWriteLock m_tokenLock;
+    QHash<QByteArray, Token> m_tokens; // bearer token -> user
+    int m_purgeAt;
+
+    int userIdFor(const HttpRequest& req);
+    User* userFor(int userId) const;
+
+    HttpResponse login(const QJsonObject& body);
+    HttpResponse logout(const HttpRequest& req);
+    HttpResponse courses(const HttpRequest& req);
+    HttpResponse enroll(int userId, const QJsonObject& body);
+    HttpResponse submit(int userId, const QJsonObject& body);
+    HttpResponse grade(int userId, const QJsonObject& body);
+    HttpResponse work(int userId);
+    HttpResponse inbox(int userId, const HttpRequest& req);
+    HttpResponse markRead(int userId, const QJsonObject& body);
+
+public:
+    explicit LmsService(LMSSystem& sys);
+
+    LmsService(const LmsService&) = delete;
+    LmsService& operator=(const LmsService&) = delete;
+
+    HttpResponse handle(const HttpRequest& req);
+};
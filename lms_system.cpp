@@ -1,71 +1,246 @@
 
 #include "lms_system.h"
 #include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
 
-LMSSystem::LMSSystem()
-    : m_userCount(0), m_courseCount(0), m_assignmentCount(0),
-    m_submissionCount(0), m_notifCount(0),
-    m_nextUserId(1), m_nextCourseId(100), m_nextAssignId(1000),
-    m_nextSubId(5000), m_nextNotifId(9000)
+// ----------------- Locking helpers -----------------
+// Write-locks a set of stripes (bit i = stripe i) in ascending order, so two
+// threads locking overlapping sets never wait on each other in a cycle.
+class ShardLocker {
+    QReadWriteLock* m_locks;
+    quint64 m_mask;
+
+public:
+    ShardLocker(QReadWriteLock* locks, quint64 mask) : m_locks(locks), m_mask(mask) {
+        for (int i = 0; i < LOCK_SHARDS; i++)
+            if (m_mask & (quint64(1) << i)) m_locks[i].lockForWrite();
+    }
+    ~ShardLocker() {
+        for (int i = LOCK_SHARDS - 1; i >= 0; i--)
+            if (m_mask & (quint64(1) << i)) m_locks[i].unlock();
+    }
+
+    ShardLocker(const ShardLocker&) = delete;
+    ShardLocker& operator=(const ShardLocker&) = delete;
+};
+
+static quint64 shardBit(int id) { return quint64(1) << (quint32(id) % LOCK_SHARDS); }
+
+// public mutations running on this thread: a checkpoint asked for by one of
+// them starts only when the outermost has finished
+static thread_local int t_mutationDepth = 0;
+
+// Bulk mode belongs to the thread that began it: what other threads change
+// meanwhile (service workers, reminders) keeps its signals and notices and
+// stays out of the summaries. Counters are summarized once at endBulk.
+struct BulkRun {
+    int depth = 0;
+    GrowArray<Course*> courses;         // with new enrollments, first-seen order
+    QHash<Course*, int> enrolled;
+    GrowArray<Faculty*> faculty;        // with new courses, first-seen order
+    QHash<Faculty*, int> assigned;
+    GrowArray<Assignment*> assignments; // with new submissions, first-seen order
+    QHash<Assignment*, int> submitted;
+};
+static thread_local BulkRun t_bulk;
+
+static bool inBulk() { return t_bulk.depth > 0; }
+
+// one item towards its end-of-bulk summary
+template<typename K>
+static void countBulk(QHash<K*, int>& counts, GrowArray<K*>& order, K* key) {
+    if (counts[key]++ == 0) order.append(key);
+}
+
+// Held for the length of one public mutation: keeps checkpoint() out, and runs
+// the checkpoint logOp() asked for once the mutation's locks are released.
+class LMSSystem::MutationScope {
+    LMSSystem* m_sys;
+
+public:
+    explicit MutationScope(LMSSystem* sys) : m_sys(sys) {
+        m_sys->m_checkpointLock.lockForRead();
+        t_mutationDepth++;
+    }
+    ~MutationScope() {
+        m_sys->m_checkpointLock.unlock();
+        if (--t_mutationDepth == 0 && m_sys->m_checkpointDue.exchange(false)) m_sys->checkpoint();
+    }
+
+    MutationScope(const MutationScope&) = delete;
+    MutationScope& operator=(const MutationScope&) = delete;
+};
+
+LMSSystem::LMSSystem(QObject* parent)
+    : QObject(parent), m_checkpointLock(QReadWriteLock::Recursive), m_checkpointDue(false),
+    m_deliveryThread(nullptr), m_deliveryStop(false), m_deliveryIdle(false), m_jobsQueued(0), m_jobsDelivered(0),
+    m_reminderThread(nullptr), m_reminderStop(false), m_reminders(REMINDER_TICK_MS), m_remindedAssignments(0),
+    m_searchedCourses(0), m_searchedAssignments(0), m_searchedNotifs(0),
+    m_pickedCourses(0), m_pickedUsers(0),
+    m_snapshotFile(nullptr), m_storeLock(nullptr), m_snapshotSeq(0), m_snapshotGen(0),
+    m_replaying(false), m_replayTimeMs(0), m_nextUserId(1), m_nextAdminId(1), m_nextFacultyId(10), m_nextStudentId(1001),
+    m_nextCourseId(100), m_nextAssignId(1000),
+    m_nextSubId(5000), m_nextNotifId(9000), m_deliveryCount(0)
 {
-    for (int i = 0; i < MAX_USERS; i++) m_users[i] = nullptr;
-    for (int i = 0; i < MAX_COURSES; i++) m_courses[i] = nullptr;
-    for (int i = 0; i < MAX_ASSIGNMENTS; i++) m_assignments[i] = nullptr;
-    for (int i = 0; i < MAX_SUBMISSIONS; i++) m_submissions[i] = nullptr;
+    m_deliveryThread = QThread::create([this]() { deliveryLoop(); });
+    m_deliveryThread->start();
+
+    m_tmplCourseAssigned = m_strings.intern(u"You have been assigned to course: %1");
+    m_tmplEnrolled = m_strings.intern(u"%1 enrolled in %2");
+    m_tmplSubmitted = m_strings.intern(u"New submission for: %1 by %2");
+    m_tmplAssignmentPosted = m_strings.intern(u"New assignment posted: %1 in %2");
+    m_tmplGraded = m_strings.intern(u"Your submission graded (%1): %2");
+    m_tmplGradedBatch = m_strings.intern(u"%1 of your submissions were graded: %2");
+    m_tmplBulkEnrolled = m_strings.intern(u"%1 new students enrolled in %2");
+    m_tmplBulkAssigned = m_strings.intern(u"You have been assigned to %1 new course(s)");
+    m_tmplBulkSubmitted = m_strings.intern(u"%1 new submissions for: %2");
+    m_tmplReminder = m_strings.intern(u"Reminder: %1 is due in %2 hours, on %3. You have not submitted yet.");
 }
 
 LMSSystem::~LMSSystem() {
-    for (int i = 0; i < m_userCount; i++) delete m_users[i];
-    for (int i = 0; i < m_courseCount; i++) delete m_courses[i];
-    for (int i = 0; i < m_assignmentCount; i++) delete m_assignments[i];
-    for (int i = 0; i < m_submissionCount; i++) delete m_submissions[i];
+    // reminders queue deliveries: stop them before the delivery thread
+    if (m_reminderThread) {
+        {
+            QMutexLocker lock(&m_reminderLock);
+            m_reminderStop = true;
+            m_reminderWake.wakeOne();
+        }
+        m_reminderThread->wait();
+        delete m_reminderThread;
+    }
+
+    // the delivery thread writes into entities: finish the queue and stop it first
+    m_deliveryStop = true;
+    {
+        QMutexLocker lock(&m_deliveryLock);
+        m_deliveryWake.wakeOne();
+    }
+    m_deliveryThread->wait();
+    delete m_deliveryThread;
+
+    // arenas destroy every entity they created; none of them read the
+    // mapped snapshot on the way out, so it can go first
+    delete m_snapshotFile;
+    delete m_storeLock;
+}
+
+QReadWriteLock& LMSSystem::courseLock(int courseId) const { return m_courseLocks[quint32(courseId) % LOCK_SHARDS]; }
+QReadWriteLock& LMSSystem::userLock(int userId) const { return m_userLocks[quint32(userId) % LOCK_SHARDS]; }
+
+bool LMSSystem::canAddUser(const QString& email) const {
+    QString key = normalizeEmail(email);
+    return !key.isEmpty() && !m_emailIndex.contains(QStringView(key));
+}
+
+void LMSSystem::addUser(User* u) {
+    m_users.append(u);
+    m_userIndex.insert(u);
+    Symbol key = m_strings.intern(normalizeEmail(u->email()));
+    m_emailIndex.insert(m_strings.view(key), u);
+}
+
+const StringPool& LMSSystem::strings() const { return m_strings; }
+
+// The directory lock covers the duplicate check, the ids and the journal
+// record, so two threads cannot take the same email or log ids out of order.
+template<typename T>
+T* LMSSystem::createUser(SlabArena<T>& arena, int& nextRoleId, JournalOp op,
+    const QString& name, const QString& email, const PasswordRecord& pass) {
+    MutationScope scope(this);
+    T* u;
+    {
+        QWriteLocker lock(&m_directoryLock);
+        if (!canAddUser(email)) return nullptr;
+        u = arena.create(m_nextUserId++, nextRoleId++,
+            m_strings.view(m_strings.intern(name)), m_strings.view(m_strings.intern(email.trimmed())), pass);
+        logOp(op, journalPayload(name, email, pass.salt, pass.hash, qint32(pass.iterations)));
+        addUser(u);
+    }
+    if (!inBulk()) emit userAdded(u);
+    return u;
+}
+
+Admin* LMSSystem::createAdmin(const QString& name, const QString& email, const PasswordRecord& pass) {
+    return createUser(m_admins, m_nextAdminId, JournalOp::CreateAdmin, name, email, pass);
+}
+
+Faculty* LMSSystem::createFaculty(const QString& name, const QString& email, const PasswordRecord& pass) {
+    return createUser(m_faculty, m_nextFacultyId, JournalOp::CreateFaculty, name, email, pass);
+}
+
+Student* LMSSystem::createStudent(const QString& name, const QString& email, const PasswordRecord& pass) {
+    return createUser(m_students, m_nextStudentId, JournalOp::CreateStudent, name, email, pass);
 }
 
 void LMSSystem::seedDemoData() {
     // Admin
-    if (m_userCount < MAX_USERS) {
-        m_users[m_userCount++] = new Admin(m_nextUserId++, 1, "Admin", "admin@lms.com", "admin");
-    }
+    Admin* admin = createAdmin("Admin", "admin@lms.com", PasswordHasher::make("admin"));
 
     // Faculty
-    if (m_userCount < MAX_USERS) {
-        m_users[m_userCount++] = new Faculty(m_nextUserId++, 10, "Dr. Ahmed", "faculty@lms.com", "1234");
-    }
+    Faculty* f = createFaculty("Dr. Ahmed", "faculty@lms.com", PasswordHasher::make("1234"));
 
     // Student
-    if (m_userCount < MAX_USERS) {
-        m_users[m_userCount++] = new Student(m_nextUserId++, 1001, "Abdul Rehman", "student@lms.com", "1234");
-    }
+    createStudent("Abdul Rehman", "student@lms.com", PasswordHasher::make("1234"));
 
     // Create one course and assign faculty
-    Admin* admin = asAdmin(m_users[0]);
     Course* c = adminCreateCourse(admin, "OOP - CS200");
-    Faculty* f = asFaculty(m_users[1]);
     adminAssignFaculty(admin, c->id(), f);
 
     // Post one assignment (demo)
     facultyCreateAssignment(f, c->id(), "Assignment 1", "Implement classes", "2025-12-20");
 }
 
-User* LMSSystem::login(const QString& email, const QString& pass) {
-    for (int i = 0; i < m_userCount; i++) {
-        if (m_users[i] && m_users[i]->email() == email && m_users[i]->checkPassword(pass)) {
-            return m_users[i];
-        }
-    }
-    return nullptr;
+QString LMSSystem::normalizeEmail(const QString& email) {
+    return email.trimmed().toCaseFolded();
 }
 
-User* LMSSystem::findUserById(int userId) const {
-    for (int i = 0; i < m_userCount; i++)
-        if (m_users[i] && m_users[i]->id() == userId) return m_users[i];
-    return nullptr;
+User* LMSSystem::findUserByEmail(const QString& email) const {
+    QString key = normalizeEmail(email);
+    QReadLocker lock(&m_directoryLock);
+    return m_emailIndex.value(QStringView(key), nullptr);
 }
 
-Course* LMSSystem::findCourseById(int courseId) const {
-    for (int i = 0; i < m_courseCount; i++)
-        if (m_courses[i] && m_courses[i]->id() == courseId) return m_courses[i];
-    return nullptr;
+SessionCache& LMSSystem::sessions() { return m_sessions; }
+
+BlobStore& LMSSystem::blobs() { return m_blobs; }
+
+User* LMSSystem::login(const QString& email, const QString& pass) {
+    User* u = findUserByEmail(email);
+    if (!u) return nullptr;
+
+    // recent successful login: skip the expensive hash
+    if (m_sessions.check(u->id(), pass)) return u;
+
+    if (!u->checkPassword(pass)) return nullptr;
+    m_sessions.remember(u->id(), pass);
+    return u;
+}
+
+User* LMSSystem::findUserById(int userId) const { return m_userIndex.find(userId); }
+Course* LMSSystem::findCourseById(int courseId) const { return m_courseIndex.find(courseId); }
+Assignment* LMSSystem::findAssignmentById(int assignmentId) const { return m_assignmentIndex.find(assignmentId); }
+Submission* LMSSystem::findSubmissionById(int submissionId) const { return m_submissionIndex.find(submissionId); }
+
+// notification ids grow with creation (and snapshot) order: no index, a binary search
+const Notification* LMSSystem::findNotificationById(int notifId) const {
+    int count;
+    {
+        QMutexLocker lock(&m_notifLock);
+        count = m_notifs.count();
+    }
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (m_notifs.at(mid)->id() < notifId) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < count && m_notifs.at(lo)->id() == notifId ? m_notifs.at(lo) : nullptr;
 }
 
 Student* LMSSystem::asStudent(User* u) const {
@@ -81,11 +256,15 @@ Admin* LMSSystem::asAdmin(User* u) const {
 // ---------------- Admin actions ----------------
 Course* LMSSystem::adminCreateCourse(Admin* admin, const QString& courseName) {
     if (!admin) return nullptr;
-    if (m_courseCount >= MAX_COURSES) return nullptr;
-
-    Course* c = new Course();
-    c->set(m_nextCourseId++, courseName);
-    m_courses[m_courseCount++] = c;
+    MutationScope scope(this);
+    Course* c;
+    {
+        QMutexLocker lock(&m_courseCreateLock);
+        c = m_courses.create(m_nextCourseId++, m_strings.view(m_strings.intern(courseName)));
+        logOp(JournalOp::CreateCourse, journalPayload(qint32(admin->id()), courseName));
+    }
+    m_courseIndex.insert(c); // findable only once it is in the journal
+    if (!inBulk()) emit courseAdded(c);
     return c;
 }
 
@@ -95,10 +274,32 @@ bool LMSSystem::adminAssignFaculty(Admin* admin, int courseId, Faculty* faculty)
     Course* c = findCourseById(courseId);
     if (!c) return false;
 
-    c->setFaculty(faculty);
-    faculty->assignCourse(c);
+    MutationScope scope(this);
+    bool isNew;
+    {
+        QWriteLocker courseLocker(&courseLock(c->id()));
+        QWriteLocker userLocker(&userLock(faculty->id()));
+        c->setFaculty(faculty);
 
-    sendNotif(admin, faculty, "You have been assigned to course: " + c->name());
+        // first time this faculty gets the course: queue what was already submitted
+        isNew = faculty->assignCourse(c);
+        if (isNew) {
+            for (int i = 0; i < c->assignmentCount(); i++) {
+                Assignment* a = c->assignmentAt(i);
+                for (int j = 0; j < a->submissionCount(); j++) faculty->addSubmission(a->submissionAt(j));
+            }
+        }
+        // in bulk mode: one summary per faculty at endBulk
+        DeliveryJob* notice = nullptr;
+        if (isNew && !inBulk()) {
+            Symbol args[] = { m_strings.intern(c->nameView()) };
+            notice = noticeTo(newNotification(admin, m_tmplCourseAssigned, args, 1), faculty);
+        }
+        logOp(JournalOp::AssignFaculty, journalPayload(qint32(admin->id()), qint32(courseId), qint32(faculty->id())),
+              &notice, 1);
+    }
+    if (!inBulk()) emit facultyAssigned(c, faculty);
+    else if (isNew) countBulk(t_bulk.assigned, t_bulk.faculty, faculty);
     return true;
 }
 
@@ -109,52 +310,132 @@ bool LMSSystem::studentEnroll(Student* student, int courseId) {
     Course* c = findCourseById(courseId);
     if (!c) return false;
 
-    if (!c->addStudent(student)) return false;
-    if (!student->enroll(c)) return false;
+    MutationScope scope(this);
+    {
+        QWriteLocker courseLocker(&courseLock(c->id()));
+        QWriteLocker userLocker(&userLock(student->id()));
+        if (student->isEnrolled(c)) return false; // short list, unlike the roster
+        student->enroll(c);
+        c->addStudent(student);
 
-    // notify faculty
-    if (c->faculty())
-        sendNotif(student, c->faculty(), student->name() + " enrolled in " + c->name());
+        // notify faculty (in bulk mode: one summary per course at endBulk)
+        DeliveryJob* notice = nullptr;
+        if (!inBulk() && c->faculty()) {
+            Symbol args[] = { m_strings.intern(student->nameView()), m_strings.intern(c->nameView()) };
+            notice = noticeTo(newNotification(student, m_tmplEnrolled, args, 2), c->faculty());
+        }
+        logOp(JournalOp::Enroll, journalPayload(qint32(student->id()), qint32(courseId)), &notice, 1);
+    }
+    if (!inBulk()) emit studentEnrolled(student, c);
+    else countBulk(t_bulk.enrolled, t_bulk.courses, c);
 
     return true;
 }
 
-Submission* LMSSystem::studentSubmit(Student* student, int assignmentId, const QString& filePath) {
+Submission* LMSSystem::studentSubmit(Student* student, int assignmentId, const QString& filePath,
+    const QByteArray& sha256, qint64 size) {
     if (!student) return nullptr;
 
-    Assignment* a = nullptr;
-    for (int i = 0; i < m_assignmentCount; i++) {
-        if (m_assignments[i] && m_assignments[i]->id() == assignmentId) {
-            a = m_assignments[i];
-            break;
-        }
-    }
+    Assignment* a = findAssignmentById(assignmentId);
     if (!a) return nullptr;
 
-    // must be enrolled in that course
     Course* c = a->course();
-    if (!c || !student->isEnrolled(c)) return nullptr;
+    if (!c) return nullptr;
 
-    if (m_submissionCount >= MAX_SUBMISSIONS) return nullptr;
+    MutationScope scope(this);
+    Submission* sub;
+    {
+        QWriteLocker courseLocker(&courseLock(c->id()));
 
-    Submission* sub = new Submission();
-    sub->set(m_nextSubId++, student, a, filePath);
+        // must be enrolled in that course
+        bool enrolled;
+        {
+            QReadLocker userLocker(&userLock(student->id()));
+            enrolled = student->isEnrolled(c);
+        }
+        if (!enrolled) return nullptr;
 
-    // Add to assignment (also prevents duplicates by same student)
-    if (!a->addSubmission(sub)) {
-        delete sub;
-        return nullptr;
-    }
+        // one submission per student (checked before allocating: arena slots are not reused)
+        if (m_submissionByStudent.contains(student->id(), a->id())) return nullptr;
 
-    m_submissions[m_submissionCount++] = sub;
+        Faculty* f = c->faculty();
+        {
+            QMutexLocker lock(&m_submissionCreateLock);
+            sub = m_submissions.create(m_nextSubId++, student, a, filePath);
+            sub->setContent(sha256, size);
+            if (!sha256.isEmpty()) m_blobs.addRef(sha256, size);
 
-    // notify faculty
-    if (c->faculty())
-        sendNotif(student, c->faculty(), "New submission for: " + a->title() + " by " + student->name());
+            // notify faculty (in bulk mode: one summary per assignment at endBulk)
+            DeliveryJob* notice = nullptr;
+            if (!inBulk() && f) {
+                Symbol args[] = { m_strings.intern(a->titleView()), m_strings.intern(student->nameView()) };
+                notice = noticeTo(newNotification(student, m_tmplSubmitted, args, 2), f);
+            }
+            logOp(JournalOp::Submit, journalPayload(qint32(student->id()), qint32(assignmentId), filePath, sha256, size),
+                  &notice, 1);
+        }
+        a->addSubmission(sub);
+        m_submissionByStudent.insert(student->id(), a->id(), sub);
+        {
+            QWriteLocker userLocker(&userLock(student->id()));
+            student->addSubmission(sub);
+        }
+        addToGradebook(sub);
+        if (f) {
+            QWriteLocker userLocker(&userLock(f->id()));
+            f->addSubmission(sub);
+        }
+    }
+    m_submissionIndex.insert(sub);
+    if (!inBulk()) emit submissionAdded(sub);
+    else countBulk(t_bulk.submitted, t_bulk.assignments, a);
 
     return sub;
 }
 
+Submission* LMSSystem::findSubmission(const Student* student, const Assignment* a) const {
+    return student && a ? m_submissionByStudent.find(student->id(), a->id()) : nullptr;
+}
+
+int LMSSystem::studentOpenAssignments(const Student* student, GrowArray<Assignment*>& out) const {
+    out.clear();
+    if (!student) return 0;
+
+    // enrollments copied first: course locks are never taken inside a user lock
+    GrowArray<Course*> courses;
+    readUser(student, [student, &courses]() {
+        courses.reserve(student->enrolledCount());
+        for (int i = 0; i < student->enrolledCount(); i++) courses.append(student->enrolledAt(i));
+    });
+    for (int i = 0; i < courses.count(); i++) {
+        Course* c = courses[i];
+        readCourse(c, [this, student, c, &out]() {
+            for (int j = 0; j < c->assignmentCount(); j++) {
+                Assignment* a = c->assignmentAt(j);
+                if (!findSubmission(student, a)) out.append(a);
+            }
+        });
+    }
+
+    Assignment** b = out.data();
+    std::stable_sort(b, b + out.count(), [](const Assignment* x, const Assignment* y) {
+        quint64 dx = x->dueMs() > 0 ? quint64(x->dueMs()) : ~quint64(0);
+        quint64 dy = y->dueMs() > 0 ? quint64(y->dueMs()) : ~quint64(0);
+        return dx < dy;
+    });
+    return out.count();
+}
+
+int LMSSystem::studentSubmissions(const Student* student, GrowArray<Submission*>& out) const {
+    out.clear();
+    if (!student) return 0;
+    return readUser(student, [student, &out]() {
+        out.reserve(student->submissionCount());
+        for (int i = 0; i < student->submissionCount(); i++) out.append(student->submissionAt(i));
+        return out.count();
+    });
+}
+
 // ---------------- Faculty actions ----------------
 Assignment* LMSSystem::facultyCreateAssignment(Faculty* faculty, int courseId,
     const QString& title, const QString& desc, const QString& due) {
@@ -163,27 +444,40 @@ Assignment* LMSSystem::facultyCreateAssignment(Faculty* faculty, int courseId,
     Course* c = findCourseById(courseId);
     if (!c) return nullptr;
 
-    // Faculty must be assigned to this course
-    if (c->faculty() != faculty) return nullptr;
+    // older journal records may hold free text: replayed without a due date
+    qint64 dueMs = Assignment::parseDueDate(due);
+    if (dueMs == 0 && !m_replaying) return nullptr;
 
-    if (m_assignmentCount >= MAX_ASSIGNMENTS) return nullptr;
+    MutationScope scope(this);
+    Assignment* a;
+    {
+        QWriteLocker courseLocker(&courseLock(c->id()));
 
-    Assignment* a = new Assignment();
-    a->set(m_nextAssignId++, title, desc, due, c);
+        // Faculty must be assigned to this course
+        if (c->faculty() != faculty) return nullptr;
 
-    // attach to course
-    if (!c->addAssignment(a)) {
-        delete a;
-        return nullptr;
-    }
-
-    m_assignments[m_assignmentCount++] = a;
+        {
+            QMutexLocker lock(&m_assignmentCreateLock);
+            a = m_assignments.create(m_nextAssignId++, m_strings.view(m_strings.intern(title)),
+                m_strings.view(m_strings.intern(desc)), dueMs, c);
+            addToGradebook(a);
+            // notify all students in course: one shared message, one inbox entry each
+            DeliveryJob* notice = nullptr;
+            if (c->studentCount() > 0) {
+                Symbol args[] = { m_strings.intern(a->titleView()), m_strings.intern(c->nameView()) };
+                notice = noticeToCourse(newNotification(faculty, m_tmplAssignmentPosted, args, 2), c);
+            }
+            // logged in UTC: replay gives the same instant in any time zone
+            QString dueUtc = QDateTime::fromMSecsSinceEpoch(dueMs).toUTC().toString(Qt::ISODate);
+            logOp(JournalOp::CreateAssignment, journalPayload(qint32(faculty->id()), qint32(courseId), title, desc, dueUtc),
+                  &notice, 1);
+        }
 
-    // notify all students in course
-    for (int i = 0; i < c->studentCount(); i++) {
-        Student* s = c->studentAt(i);
-        if (s) sendNotif(faculty, s, "New assignment posted: " + a->title() + " in " + c->name());
+        // attach to course
+        c->addAssignment(a);
     }
+    m_assignmentIndex.insert(a);
+    if (!inBulk()) emit assignmentPosted(a);
 
     return a;
 }
@@ -191,48 +485,822 @@ Assignment* LMSSystem::facultyCreateAssignment(Faculty* faculty, int courseId,
 bool LMSSystem::facultyGradeSubmission(Faculty* faculty, int submissionId, float grade) {
     if (!faculty) return false;
 
-    Submission* sub = nullptr;
-    for (int i = 0; i < m_submissionCount; i++) {
-        if (m_submissions[i] && m_submissions[i]->id() == submissionId) {
-            sub = m_submissions[i];
-            break;
-        }
-    }
+    Submission* sub = findSubmissionById(submissionId);
     if (!sub) return false;
 
     Assignment* a = sub->assignment();
     if (!a || !a->course()) return false;
 
-    // Ensure faculty owns that course
-    if (a->course()->faculty() != faculty) return false;
+    MutationScope scope(this);
+    {
+        QWriteLocker courseLocker(&courseLock(a->course()->id()));
 
-    sub->setGrade(grade);
+        // Ensure faculty owns that course
+        if (a->course()->faculty() != faculty) return false;
 
-    // notify student
-    Student* s = sub->student();
-    if (s) sendNotif(faculty, s, "Your submission graded (" + a->title() + "): " + QString::number(grade));
+        setGrade(sub, grade);
+
+        // notify student
+        DeliveryJob* notice = nullptr;
+        if (sub->student()) {
+            Symbol args[] = { m_strings.intern(a->titleView()), m_strings.intern(QString::number(grade)) };
+            notice = noticeTo(newNotification(faculty, m_tmplGraded, args, 2), sub->student());
+        }
+        logOp(JournalOp::Grade, journalPayload(qint32(faculty->id()), qint32(submissionId), grade), &notice, 1);
+    }
+    if (!inBulk()) emit submissionGraded(sub);
 
     return true;
 }
 
+// per student: what one batch graded
+struct StudentGrades {
+    Submission* first;
+    float firstGrade;
+    int count;
+    QString detail;
+};
+
+int LMSSystem::facultyGradeBatch(Faculty* faculty, const GradeEntry* entries, int count) {
+    if (!faculty || !entries || count <= 0) return 0;
+
+    MutationScope scope(this);
+
+    // resolve first, so every course the batch touches is locked once, up front
+    GrowArray<Submission*> subs;
+    subs.reserve(count);
+    quint64 shards = 0;
+    for (int i = 0; i < count; i++) {
+        Submission* sub = findSubmissionById(entries[i].submissionId);
+        if (sub && (!sub->assignment() || !sub->assignment()->course())) sub = nullptr;
+        if (sub) shards |= shardBit(sub->assignment()->course()->id());
+        subs.append(sub);
+    }
+
+    QHash<Course*, bool> owns; // ownership checked once per course
+    GrowArray<Student*> students; // first-seen order
+    QHash<Student*, StudentGrades> grades;
+    int graded = 0;
+    {
+        ShardLocker courseLocker(m_courseLocks, shards);
+
+        for (int i = 0; i < count; i++) {
+            Submission* sub = subs[i];
+            if (!sub) continue;
+
+            Course* c = sub->assignment()->course();
+            auto own = owns.constFind(c);
+            bool ok = own != owns.constEnd() ? own.value() : c->faculty() == faculty;
+            if (own == owns.constEnd()) owns.insert(c, ok);
+            if (!ok) continue;
+
+            setGrade(sub, entries[i].grade);
+            graded++;
+
+            Student* s = sub->student();
+            if (!s) continue;
+            if (!grades.contains(s)) {
+                grades.insert(s, StudentGrades{ sub, entries[i].grade, 0, QString() });
+                students.append(s);
+            }
+            StudentGrades& g = grades[s];
+            if (g.count++ > 0) g.detail += ", ";
+            g.detail += sub->assignment()->title() + " " + QString::number(entries[i].grade);
+        }
+        if (graded == 0) return 0;
+
+        // one notification per student for the whole batch
+        GrowArray<DeliveryJob*> notices;
+        notices.reserve(students.count());
+        for (int i = 0; i < students.count(); i++) {
+            const StudentGrades& g = grades[students[i]];
+            Notification* n;
+            if (g.count == 1) {
+                Symbol args[] = { m_strings.intern(g.first->assignment()->titleView()),
+                    m_strings.intern(QString::number(g.firstGrade)) };
+                n = newNotification(faculty, m_tmplGraded, args, 2);
+            } else {
+                Symbol args[] = { m_strings.intern(QString::number(g.count)), m_strings.intern(g.detail) };
+                n = newNotification(faculty, m_tmplGradedBatch, args, 2);
+            }
+            notices.append(noticeTo(n, students[i]));
+        }
+
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << qint32(faculty->id()) << qint32(count);
+        for (int i = 0; i < count; i++) out << qint32(entries[i].submissionId) << entries[i].grade;
+        logOp(JournalOp::GradeBatch, payload, notices.data(), notices.count());
+    }
+    if (!inBulk()) emit submissionsGraded(faculty, graded);
+
+    return graded;
+}
+
+// ---------------- Gradebook ----------------
+void LMSSystem::addToGradebook(Assignment* a) {
+    a->setGradeColumn(m_gradebook.addColumn());
+}
+
+void LMSSystem::addToGradebook(Submission* sub) {
+    Assignment* a = sub->assignment();
+    if (!a) return;
+    sub->setGradeRow(m_gradebook.addRow(a->gradeColumn(), sub->student() ? sub->student()->id() : -1));
+    if (sub->status() == SubmissionStatus::Graded)
+        m_gradebook.setGrade(a->gradeColumn(), sub->gradeRow(), sub->grade());
+}
+
+void LMSSystem::setGrade(Submission* sub, float grade) {
+    sub->setGrade(grade);
+    if (sub->assignment()) m_gradebook.setGrade(sub->assignment()->gradeColumn(), sub->gradeRow(), grade);
+}
+
+const Gradebook& LMSSystem::gradebook() const { return m_gradebook; }
+
+GradeStats LMSSystem::assignmentStats(Assignment* a) const {
+    if (!a || !a->course()) return GradeStats();
+    return readCourse(a->course(), [&]() { return m_gradebook.stats(a->gradeColumn()); });
+}
+
+GradeStats LMSSystem::courseStats(Course* c) const {
+    if (!c) return GradeStats();
+    return readCourse(c, [&]() {
+        GrowArray<int> columns;
+        columns.reserve(c->assignmentCount());
+        for (int i = 0; i < c->assignmentCount(); i++) columns.append(c->assignmentAt(i)->gradeColumn());
+        return m_gradebook.stats(columns.data(), columns.count());
+    });
+}
+
 // ---------------- Getters for UI ----------------
-int LMSSystem::courseCount() const { return m_courseCount; }
-Course* LMSSystem::courseAt(int i) const { return (i >= 0 && i < m_courseCount) ? m_courses[i] : nullptr; }
+int LMSSystem::userCount() const {
+    QReadLocker lock(&m_directoryLock);
+    return m_users.count();
+}
+
+User* LMSSystem::userAt(int i) const {
+    QReadLocker lock(&m_directoryLock);
+    return (i >= 0 && i < m_users.count()) ? m_users[i] : nullptr;
+}
+
+int LMSSystem::courseCount() const { return m_courses.count(); }
+Course* LMSSystem::courseAt(int i) const { return m_courses.at(i); }
 
-int LMSSystem::notifCount() const { return m_notifCount; }
-const Notification& LMSSystem::notifAt(int i) const { return m_notifs[i]; }
+int LMSSystem::notifCount() const { return m_notifs.count(); }
+int LMSSystem::deliveryCount() const { return m_deliveryCount; }
 
-int LMSSystem::assignmentCount() const { return m_assignmentCount; }
-Assignment* LMSSystem::assignmentAt(int i) const { return (i >= 0 && i < m_assignmentCount) ? m_assignments[i] : nullptr; }
+int LMSSystem::assignmentCount() const { return m_assignments.count(); }
+Assignment* LMSSystem::assignmentAt(int i) const { return m_assignments.at(i); }
 
-int LMSSystem::submissionCount() const { return m_submissionCount; }
-Submission* LMSSystem::submissionAt(int i) const { return (i >= 0 && i < m_submissionCount) ? m_submissions[i] : nullptr; }
+int LMSSystem::submissionCount() const { return m_submissions.count(); }
+Submission* LMSSystem::submissionAt(int i) const { return m_submissions.at(i); }
 
 // ---------------- Notifications ----------------
+Notification* LMSSystem::newNotification(User* sender, Symbol tmpl, const Symbol* args, int argCount) {
+    QMutexLocker lock(&m_notifLock);
+    Notification* n = m_notifs.create();
+    n->set(m_nextNotifId++, &m_strings, tmpl, args, argCount, sender, now());
+    return n;
+}
+
+void LMSSystem::enqueue(DeliveryJob* job) {
+    m_jobsQueued++;
+    m_deliveryQueue.push(job);
+    if (m_deliveryIdle) {
+        QMutexLocker lock(&m_deliveryLock);
+        m_deliveryWake.wakeOne();
+    }
+}
+
+LMSSystem::DeliveryJob* LMSSystem::noticeTo(Notification* n, User* receiver) {
+    if (!receiver) return nullptr;
+    DeliveryJob* job = new DeliveryJob;
+    job->notif = n;
+    job->receiver = receiver;
+    return job;
+}
+
+// free text is interned as an argument-less template
 void LMSSystem::sendNotif(User* sender, User* receiver, const QString& msg) {
     if (!receiver) return;
-    if (m_notifCount >= MAX_NOTIFS) return;
+    MutationScope scope(this);
+    DeliveryJob* notice = noticeTo(newNotification(sender, m_strings.intern(msg)), receiver);
+    logOp(JournalOp::SendNotif, journalPayload(qint32(sender ? sender->id() : -1), qint32(receiver->id()), msg),
+          &notice, 1);
+}
+
+void LMSSystem::broadcastNotif(User* sender, User* const* receivers, int count, const QString& msg) {
+    if (!receivers || count <= 0) return;
+    MutationScope scope(this);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << qint32(sender ? sender->id() : -1) << msg << qint32(count);
+    for (int i = 0; i < count; i++) out << qint32(receivers[i] ? receivers[i]->id() : -1);
+
+    // the caller's array is only borrowed: the job gets its own copy
+    DeliveryJob* job = new DeliveryJob;
+    job->notif = newNotification(sender, m_strings.intern(msg));
+    job->receivers = new User*[count];
+    for (int i = 0; i < count; i++)
+        if (receivers[i]) job->receivers[job->count++] = receivers[i];
+    logOp(JournalOp::BroadcastNotif, payload, &job, 1);
+}
+
+void LMSSystem::broadcastToCourse(User* sender, Course* c, const QString& msg) {
+    if (!c) return;
+
+    MutationScope scope(this);
+    QReadLocker courseLocker(&courseLock(c->id()));
+    if (c->studentCount() == 0) return;
+    DeliveryJob* notice = noticeToCourse(newNotification(sender, m_strings.intern(msg)), c);
+    logOp(JournalOp::BroadcastToCourse, journalPayload(qint32(sender ? sender->id() : -1), qint32(c->id()), msg),
+          &notice, 1);
+}
+
+// O(1) for the poster however big the course: only the roster length is taken
+LMSSystem::DeliveryJob* LMSSystem::noticeToCourse(Notification* n, Course* c) {
+    DeliveryJob* job = new DeliveryJob;
+    job->notif = n;
+    job->course = c;
+    job->count = c->studentCount();
+    return job;
+}
+
+// ---------------- Delivery thread ----------------
+// one inbox entry to write
+struct InboxWrite {
+    User* user;
+    Notification* notif;
+    int shard;
+};
+
+void LMSSystem::deliveryLoop() {
+    GrowArray<DeliveryJob*> jobs;
+    jobs.reserve(DELIVERY_BATCH_JOBS);
+    for (;;) {
+        jobs.clear();
+        while (jobs.count() < DELIVERY_BATCH_JOBS) {
+            DeliveryJob* job = m_deliveryQueue.pop();
+            if (!job) break;
+            jobs.append(job);
+        }
+
+        if (jobs.count() > 0) {
+            deliverBatch(jobs.data(), jobs.count());
+            m_jobsDelivered += jobs.count();
+            {
+                QMutexLocker lock(&m_deliveryLock);
+                m_deliveryDone.wakeAll();
+            }
+            emit notificationsDelivered();
+            continue;
+        }
+
+        // nothing to do: announce the nap first, then look once more, so a
+        // producer pushing in between either is seen here or sees the flag
+        QMutexLocker lock(&m_deliveryLock);
+        m_deliveryIdle = true;
+        bool stop = m_deliveryStop;
+        if (m_deliveryQueue.isEmpty() && !stop) m_deliveryWake.wait(&m_deliveryLock, DELIVERY_IDLE_WAIT_MS);
+        m_deliveryIdle = false;
+        if (stop && m_deliveryQueue.isEmpty()) return;
+    }
+}
+
+// Expands the jobs into inbox entries and writes them grouped by user-lock
+// stripe: one lock round trip per stripe per pass instead of one per entry.
+// Each inbox still gets its entries in queue order.
+void LMSSystem::deliverBatch(DeliveryJob* const* jobs, int n) {
+    GrowArray<InboxWrite> writes;
+    for (int j = 0; j < n; j++) {
+        DeliveryJob* job = jobs[j];
+        if (job->receiver) {
+            writes.append(InboxWrite{ job->receiver, job->notif, int(quint32(job->receiver->id()) % LOCK_SHARDS) });
+        } else if (job->course) {
+            QReadLocker lock(&courseLock(job->course->id()));
+            writes.reserve(writes.count() + job->count);
+            for (int i = 0; i < job->count; i++) {
+                Student* s = job->course->studentAt(i);
+                writes.append(InboxWrite{ s, job->notif, int(quint32(s->id()) % LOCK_SHARDS) });
+            }
+        } else {
+            writes.reserve(writes.count() + job->count);
+            for (int i = 0; i < job->count; i++)
+                writes.append(InboxWrite{ job->receivers[i], job->notif, int(quint32(job->receivers[i]->id()) % LOCK_SHARDS) });
+        }
+        delete[] job->receivers;
+        delete job;
+    }
+
+    InboxWrite* w = writes.data();
+    int count = writes.count();
+    std::stable_sort(w, w + count, [](const InboxWrite& a, const InboxWrite& b) { return a.shard < b.shard; });
+    for (int i = 0; i < count;) {
+        int shard = w[i].shard;
+        QWriteLocker lock(&m_userLocks[shard]);
+        for (; i < count && w[i].shard == shard; i++) {
+            w[i].user->inbox().append(w[i].notif);
+            w[i].notif->addRecipients(1);
+        }
+    }
+    m_deliveryCount += count;
+}
+
+void LMSSystem::flushNotifications() const {
+    qint64 target = m_jobsQueued;
+    QMutexLocker lock(&m_deliveryLock);
+    while (m_jobsDelivered < target) {
+        m_deliveryWake.wakeOne();
+        m_deliveryDone.wait(&m_deliveryLock, DELIVERY_IDLE_WAIT_MS);
+    }
+}
+
+// Decoding a packed inbox writes it: do that once, exclusively, and never
+// while a checkpoint is copying the packed entries out.
+void LMSSystem::unpackInbox(const User* u) const {
+    {
+        QReadLocker lock(&userLock(u->id()));
+        if (!u->inbox().isPacked()) return;
+    }
+    QReadLocker checkpointLock(&m_checkpointLock);
+    QWriteLocker lock(&userLock(u->id()));
+    u->inbox().unpack();
+}
+
+bool LMSSystem::markRead(User* u, int index) {
+    if (!u) return false;
+    MutationScope scope(this);
+    QWriteLocker lock(&userLock(u->id()));
+    if (index < 0 || index >= u->inbox().count()) return false;
+    u->inbox().markRead(index);
+    logOp(JournalOp::MarkRead, journalPayload(qint32(u->id()), qint32(index)));
+    return true;
+}
+
+// logs how many entries were there: replay may have delivered more by then
+void LMSSystem::markAllRead(User* u, int end) {
+    if (!u) return;
+    MutationScope scope(this);
+    QWriteLocker lock(&userLock(u->id()));
+    int count = u->inbox().count();
+    if (end < 0 || end > count) end = count;
+    u->inbox().markAllRead(end);
+    logOp(JournalOp::MarkAllRead, journalPayload(qint32(u->id()), qint32(end)));
+}
+
+void LMSSystem::markRangeRead(User* u, int begin, int end) {
+    if (!u) return;
+    MutationScope scope(this);
+    QWriteLocker lock(&userLock(u->id()));
+    begin = qMax(begin, 0);
+    end = qMin(end, u->inbox().count());
+    if (begin >= end) return;
+    u->inbox().markRangeRead(begin, end);
+    logOp(JournalOp::MarkRangeRead, journalPayload(qint32(u->id()), qint32(begin), qint32(end)));
+}
+
+// ---------------- Search ----------------
+void LMSSystem::updateSearchIndex() {
+    QMutexLocker lock(&m_searchUpdateLock);
 
-    m_notifs[m_notifCount].set(m_nextNotifId++, msg, sender, receiver, QDateTime::currentDateTime());
-    m_notifCount++;
+    // counts taken under the creation locks: everything below them is fully built
+    int courses, assignments, notifs;
+    { QMutexLocker l(&m_courseCreateLock); courses = m_courses.count(); }
+    { QMutexLocker l(&m_assignmentCreateLock); assignments = m_assignments.count(); }
+    { QMutexLocker l(&m_notifLock); notifs = m_notifs.count(); }
+
+    for (; m_searchedCourses < courses; m_searchedCourses++) {
+        const Course* c = m_courses.at(m_searchedCourses);
+        QString fields[] = { c->name() };
+        int weights[] = { SEARCH_WEIGHT_TITLE };
+        m_search.add(SearchKind::Course, c->id(), fields, weights, 1);
+    }
+    for (; m_searchedAssignments < assignments; m_searchedAssignments++) {
+        const Assignment* a = m_assignments.at(m_searchedAssignments);
+        QString fields[] = { a->title(), a->description() };
+        int weights[] = { SEARCH_WEIGHT_TITLE, SEARCH_WEIGHT_BODY };
+        m_search.add(SearchKind::Assignment, a->id(), fields, weights, 2);
+    }
+    for (; m_searchedNotifs < notifs; m_searchedNotifs++) {
+        const Notification* n = m_notifs.at(m_searchedNotifs);
+        QString fields[] = { n->message() };
+        int weights[] = { SEARCH_WEIGHT_BODY };
+        m_notifSearch.add(SearchKind::Notification, n->id(), fields, weights, 1);
+    }
+}
+
+void LMSSystem::search(const User* viewer, const QString& query, GrowArray<SearchHit>& out, int max) {
+    updateSearchIndex();
+    GrowArray<SearchHit> hits;
+    m_search.search(query, hits, max);
+
+    GrowArray<SearchHit> notifs;
+    if (viewer && viewer->role() == Role::Admin) {
+        m_notifSearch.search(query, notifs, max);
+    } else if (viewer) {
+        // others: the newest part of their own inbox, scored directly
+        GrowArray<int> mine;
+        readUser(viewer, [viewer, &mine]() {
+            const Inbox& in = viewer->inbox();
+            int from = qMax(0, in.count() - SEARCH_MAX_SCANNED);
+            mine.reserve(in.count() - from);
+            for (int i = in.count() - 1; i >= from; i--) {
+                const Notification* n = in.at(i);
+                if (n) mine.append(n->id());
+            }
+        });
+        m_notifSearch.searchAmong(query, SearchKind::Notification, mine.data(), mine.count(), notifs, max);
+    }
+
+    for (int i = 0; i < notifs.count(); i++) hits.append(notifs[i]);
+    SearchHit* h = hits.data();
+    std::stable_sort(h, h + hits.count(), [](const SearchHit& a, const SearchHit& b) { return a.score > b.score; });
+    out.clear();
+    int n = qMin(max, hits.count());
+    out.reserve(n);
+    for (int i = 0; i < n; i++) out.append(h[i]);
+}
+
+// ---------------- Deadline reminders ----------------
+void LMSSystem::startReminders() {
+    QMutexLocker lock(&m_reminderLock);
+    if (m_reminderThread) return;
+    m_reminderThread = QThread::create([this]() { reminderLoop(); });
+    m_reminderThread->start();
+}
+
+void LMSSystem::reminderLoop() {
+    for (;;) {
+        sendDueReminders(QDateTime::currentMSecsSinceEpoch());
+        QMutexLocker lock(&m_reminderLock);
+        if (m_reminderStop) return;
+        m_reminderWake.wait(&m_reminderLock, REMINDER_TICK_MS);
+        if (m_reminderStop) return;
+    }
+}
+
+int LMSSystem::sendDueReminders(qint64 nowMs) {
+    GrowArray<int> fired;
+    {
+        QMutexLocker lock(&m_reminderLock);
+        if (m_reminders.pending() == 0) m_reminders.reset(nowMs); // empty: no tick to walk through
+
+        // new assignments since the last tick; only reminders still ahead
+        int assignments;
+        { QMutexLocker l(&m_assignmentCreateLock); assignments = m_assignments.count(); }
+        for (; m_remindedAssignments < assignments; m_remindedAssignments++) {
+            qint64 due = m_assignments.at(m_remindedAssignments)->dueMs();
+            if (due <= 0) continue;
+            for (int r = 0; r < REMINDER_COUNT; r++) {
+                qint64 at = due - qint64(REMINDER_HOURS_BEFORE[r]) * 3600 * 1000;
+                if (at > nowMs) m_reminders.schedule(at, m_remindedAssignments * REMINDER_COUNT + r);
+            }
+        }
+        m_reminders.advance(nowMs, fired);
+    }
+
+    for (int i = 0; i < fired.count(); i++)
+        remind(m_assignments.at(fired[i] / REMINDER_COUNT), fired[i] % REMINDER_COUNT);
+    return fired.count();
+}
+
+// one notice to the course's students without a submission
+void LMSSystem::remind(Assignment* a, int reminder) {
+    Course* c = a ? a->course() : nullptr;
+    if (!c || reminder < 0 || reminder >= REMINDER_COUNT) return;
+
+    MutationScope scope(this);
+    DeliveryJob* job = new DeliveryJob;
+    bool queued = readCourse(c, [this, a, c, reminder, job]() {
+        job->receivers = new User*[c->studentCount()];
+        for (int i = 0; i < c->studentCount(); i++)
+            if (!findSubmission(c->studentAt(i), a)) job->receivers[job->count++] = c->studentAt(i);
+        if (job->count == 0) return false;
+
+        Symbol args[] = {
+            m_strings.intern(a->title() + " (" + c->name() + ")"),
+            m_strings.intern(QString::number(REMINDER_HOURS_BEFORE[reminder])),
+            m_strings.intern(a->dueDate())
+        };
+        job->notif = newNotification(nullptr, m_tmplReminder, args, 3);
+        // logged with the roster held: replay sees the same submissions
+        logOp(JournalOp::Remind, journalPayload(qint32(a->id()), qint32(reminder)), &job, 1);
+        return true;
+    });
+    if (!queued) { // the delivery thread owns a queued job
+        delete[] job->receivers;
+        delete job;
+    }
+}
+
+// ---------------- Type-ahead ----------------
+void LMSSystem::updatePickIndex() {
+    int courses = courseCount();
+    int users = userCount();
+    {
+        QReadLocker lock(&m_pickLock);
+        if (m_pickedCourses == courses && m_pickedUsers == users) return; // the common case
+    }
+
+    // counts taken under the creation locks: everything below them is fully built
+    { QMutexLocker l(&m_courseCreateLock); courses = m_courses.count(); }
+    QWriteLocker lock(&m_pickLock);
+    for (; m_pickedCourses < courses; m_pickedCourses++) {
+        const Course* c = m_courses.at(m_pickedCourses);
+        m_pickCourses.insert(QString::number(c->id()), c->id());
+        m_pickCourses.insertWords(c->name(), c->id());
+    }
+    for (; m_pickedUsers < users; m_pickedUsers++) {
+        const User* u = userAt(m_pickedUsers);
+        PrefixTrie* trie = u->role() == Role::Faculty ? &m_pickFaculty
+            : u->role() == Role::Student ? &m_pickStudents : nullptr;
+        if (!trie) continue;
+        trie->insertWords(u->name(), u->id());
+        trie->insert(PrefixTrie::normalize(u->email()), u->id());
+    }
+}
+
+int LMSSystem::complete(PickKind kind, const QString& prefix, int* ids, int max,
+    const std::function<bool(int)>& accept) {
+    if (max <= 0) return 0;
+    updatePickIndex();
+    QString key = PrefixTrie::normalize(prefix);
+    QReadLocker lock(&m_pickLock);
+    const PrefixTrie& trie = kind == PickKind::Course ? m_pickCourses
+        : kind == PickKind::Faculty ? m_pickFaculty : m_pickStudents;
+    return trie.complete(key, ids, max, accept);
+}
+
+// ---------------- Bulk changes ----------------
+void LMSSystem::beginBulk() {
+    MutationScope scope(this);
+    logOp(JournalOp::BulkBegin, QByteArray());
+    t_bulk.depth++;
+}
+
+void LMSSystem::endBulk() {
+    MutationScope scope(this);
+    if (t_bulk.depth == 0 || --t_bulk.depth > 0) return;
+    BulkRun& run = t_bulk;
+
+    // one summary per course / faculty instead of one notice per row
+    GrowArray<DeliveryJob*> notices;
+    for (int i = 0; i < run.courses.count(); i++) {
+        Course* c = run.courses[i];
+        Faculty* f = readCourse(c, [c]() { return c->faculty(); });
+        if (!f) continue;
+        Symbol args[] = { m_strings.intern(QString::number(run.enrolled.value(c))), m_strings.intern(c->nameView()) };
+        notices.append(noticeTo(newNotification(nullptr, m_tmplBulkEnrolled, args, 2), f));
+    }
+    for (int i = 0; i < run.faculty.count(); i++) {
+        Faculty* f = run.faculty[i];
+        Symbol args[] = { m_strings.intern(QString::number(run.assigned.value(f))) };
+        notices.append(noticeTo(newNotification(nullptr, m_tmplBulkAssigned, args, 1), f));
+    }
+    for (int i = 0; i < run.assignments.count(); i++) {
+        Assignment* a = run.assignments[i];
+        Course* c = a->course();
+        Faculty* f = c ? readCourse(c, [c]() { return c->faculty(); }) : nullptr;
+        if (!f) continue;
+        Symbol args[] = { m_strings.intern(QString::number(run.submitted.value(a))), m_strings.intern(a->titleView()) };
+        notices.append(noticeTo(newNotification(nullptr, m_tmplBulkSubmitted, args, 2), f));
+    }
+    logOp(JournalOp::BulkEnd, QByteArray(), notices.data(), notices.count());
+    run.courses.clear();
+    run.enrolled.clear();
+    run.faculty.clear();
+    run.assigned.clear();
+    run.assignments.clear();
+    run.submitted.clear();
+    emit bulkImported();
+}
+
+// ---------------- Journal ----------------
+QDateTime LMSSystem::now() const {
+    return m_replaying ? QDateTime::fromMSecsSinceEpoch(m_replayTimeMs) : QDateTime::currentDateTime();
+}
+
+// The record and the notices it caused are queued as one step, so inboxes fill
+// in journal order and replay puts each notice at the same inbox position
+// (read marks are logged as positions).
+void LMSSystem::logOp(JournalOp op, const QByteArray& payload, DeliveryJob* const* notices, int noticeCount) {
+    QMutexLocker lock(&m_logLock);
+    for (int i = 0; i < noticeCount; i++)
+        if (notices[i]) enqueue(notices[i]);
+    if (m_replaying || !m_journal.isOpen()) return;
+    m_journal.append(op, QDateTime::currentMSecsSinceEpoch(), payload,
+                     inBulk() ? 0 : JOURNAL_FLAG_OUTSIDE_BULK);
+    // the caller still holds its locks: checkpoint when its MutationScope ends
+    if (m_journal.size() >= JOURNAL_CHECKPOINT_BYTES) m_checkpointDue = true;
+}
+
+bool LMSSystem::openJournal(const QString& journalPath, const QString& snapshotPath, FsyncPolicy policy) {
+    m_checkpointPath = snapshotPath;
+    m_replaying = true;
+    bool ok = m_journal.open(journalPath, m_snapshotSeq,
+        [this](JournalOp op, quint8 flags, qint64 timeMs, QDataStream& in) { applyJournalRecord(op, flags, timeMs, in); },
+        policy);
+    m_replaying = false;
+    if (!ok) {
+        m_checkpointPath.clear(); // never checkpoint a half-replayed state over the store
+        return false;
+    }
+
+    // crashed in the middle of a bulk change: close it (and log that) now
+    while (inBulk()) endBulk();
+    return true;
+}
+
+bool LMSSystem::checkpoint() {
+    if (m_checkpointPath.isEmpty()) return false;
+    QWriteLocker lock(&m_checkpointLock); // waits for running mutations, holds off new ones
+    flushNotifications(); // inboxes are in the snapshot, the notices are not journaled
+    m_journal.commit();
+    // a new file: the loaded one is still mapped and cannot be replaced on Windows
+    if (!saveSnapshot(m_checkpointPath + "." + QString::number(m_snapshotGen + 1))) return false;
+    m_snapshotGen++;
+    removeOldSnapshots();
+    return m_journal.reset();
+}
+
+// <base>.<n> -> n; the unnumbered base (older versions) is generation 0
+static bool snapshotGeneration(const QString& fileName, const QString& baseName, quint64& gen) {
+    if (fileName == baseName) {
+        gen = 0;
+        return true;
+    }
+    if (!fileName.startsWith(baseName + ".")) return false;
+    bool ok = false;
+    gen = fileName.mid(baseName.size() + 1).toULongLong(&ok);
+    return ok;
+}
+
+// every generation below the newest, except the mapped one (removed at a later start)
+void LMSSystem::removeOldSnapshots() {
+    QFileInfo base(m_checkpointPath);
+    QString mapped = m_snapshotFile ? QFileInfo(m_snapshotFile->fileName()).absoluteFilePath() : QString();
+    const QFileInfoList files = base.dir().entryInfoList(QStringList(base.fileName() + "*"), QDir::Files);
+    for (const QFileInfo& fi : files) {
+        quint64 gen;
+        if (snapshotGeneration(fi.fileName(), base.fileName(), gen) && gen < m_snapshotGen
+            && fi.absoluteFilePath() != mapped)
+            QFile::remove(fi.filePath());
+    }
+}
+
+bool LMSSystem::openStore(const QString& dir, FsyncPolicy policy) {
+    QDir().mkpath(dir);
+
+    // the GUI and the service must not write one journal at the same time;
+    // a lock left by a crashed process is taken over (its pid is gone)
+    m_storeLock = new QLockFile(dir + "/" + STORE_LOCK_FILE_NAME);
+    m_storeLock->setStaleLockTime(0);
+    if (!m_storeLock->tryLock(0)) {
+        delete m_storeLock;
+        m_storeLock = nullptr;
+        return false;
+    }
+
+    m_blobs.open(dir + "/" + SUBMISSION_STORE_DIR_NAME);
+    m_checkpointPath = dir + "/" + SNAPSHOT_FILE_NAME;
+
+    // newest generation that loads (none on first run); a damaged newer one is
+    // skipped, and its number is not reused. An older one only opens if the
+    // journal still continues from it (openJournal fails on a gap).
+    GrowArray<quint64> gens;
+    const QStringList files = QDir(dir).entryList(QStringList(QString(SNAPSHOT_FILE_NAME) + "*"), QDir::Files);
+    for (const QString& name : files) {
+        quint64 gen;
+        if (snapshotGeneration(name, SNAPSHOT_FILE_NAME, gen)) gens.append(gen);
+    }
+    quint64* g = gens.data();
+    std::sort(g, g + gens.count());
+    m_snapshotGen = gens.isEmpty() ? 0 : g[gens.count() - 1];
+    for (int i = gens.count() - 1; i >= 0; i--) {
+        QString path = g[i] == 0 ? m_checkpointPath : m_checkpointPath + "." + QString::number(g[i]);
+        if (loadSnapshot(path)) break;
+    }
+    removeOldSnapshots();
+    return openJournal(dir + "/" + JOURNAL_FILE_NAME, m_checkpointPath, policy);
+}
+
+QString LMSSystem::snapshotPath() const {
+    return m_snapshotGen == 0 ? m_checkpointPath : m_checkpointPath + "." + QString::number(m_snapshotGen);
+}
+
+QString LMSSystem::defaultStoreDir() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+}
+
+// Re-runs one logged mutation through the normal API (ids come out the same
+// because the generators were restored with the snapshot).
+void LMSSystem::applyJournalRecord(JournalOp op, quint8 flags, qint64 timeMs, QDataStream& in) {
+    m_replayTimeMs = timeMs;
+    // replay runs on one thread: step out of the bulk run for records another
+    // thread made while it was open
+    int bulkDepth = t_bulk.depth;
+    if ((flags & JOURNAL_FLAG_OUTSIDE_BULK) && op != JournalOp::BulkBegin && op != JournalOp::BulkEnd)
+        t_bulk.depth = 0;
+    qint32 a = -1, b = -1, c = -1;
+    QString s1, s2, s3;
+
+    switch (op) {
+    case JournalOp::CreateAdmin:
+    case JournalOp::CreateFaculty:
+    case JournalOp::CreateStudent: {
+        PasswordRecord pass;
+        qint32 iterations = 0;
+        in >> s1 >> s2 >> pass.salt >> pass.hash >> iterations;
+        pass.iterations = iterations;
+        if (op == JournalOp::CreateAdmin) createAdmin(s1, s2, pass);
+        else if (op == JournalOp::CreateFaculty) createFaculty(s1, s2, pass);
+        else createStudent(s1, s2, pass);
+        break;
+    }
+    case JournalOp::CreateCourse:
+        in >> a >> s1;
+        adminCreateCourse(asAdmin(findUserById(a)), s1);
+        break;
+    case JournalOp::AssignFaculty:
+        in >> a >> b >> c;
+        adminAssignFaculty(asAdmin(findUserById(a)), b, asFaculty(findUserById(c)));
+        break;
+    case JournalOp::Enroll:
+        in >> a >> b;
+        studentEnroll(asStudent(findUserById(a)), b);
+        break;
+    case JournalOp::Submit: {
+        QByteArray sha256;
+        qint64 size = 0;
+        in >> a >> b >> s1 >> sha256 >> size; // older records end after the path
+        studentSubmit(asStudent(findUserById(a)), b, s1, sha256, size);
+        break;
+    }
+    case JournalOp::CreateAssignment:
+        in >> a >> b >> s1 >> s2 >> s3;
+        facultyCreateAssignment(asFaculty(findUserById(a)), b, s1, s2, s3);
+        break;
+    case JournalOp::Grade: {
+        float grade = 0.0f;
+        in >> a >> b >> grade;
+        facultyGradeSubmission(asFaculty(findUserById(a)), b, grade);
+        break;
+    }
+    case JournalOp::SendNotif:
+        in >> a >> b >> s1;
+        sendNotif(findUserById(a), findUserById(b), s1);
+        break;
+    case JournalOp::BroadcastNotif: {
+        in >> a >> s1 >> b;
+        if (b <= 0) break;
+        User** receivers = new User*[b];
+        for (int i = 0; i < b; i++) {
+            in >> c;
+            receivers[i] = findUserById(c);
+        }
+        broadcastNotif(findUserById(a), receivers, b, s1);
+        delete[] receivers;
+        break;
+    }
+    case JournalOp::BroadcastToCourse:
+        in >> a >> b >> s1;
+        broadcastToCourse(findUserById(a), findCourseById(b), s1);
+        break;
+    case JournalOp::GradeBatch: {
+        in >> a >> b;
+        if (b <= 0) break;
+        GradeEntry* entries = new GradeEntry[b];
+        for (int i = 0; i < b; i++) in >> entries[i].submissionId >> entries[i].grade;
+        facultyGradeBatch(asFaculty(findUserById(a)), entries, b);
+        delete[] entries;
+        break;
+    }
+    case JournalOp::MarkRead:
+    case JournalOp::MarkAllRead:
+        // indexes refer to the inbox as delivered when the record was written
+        in >> a >> b;
+        flushNotifications();
+        if (op == JournalOp::MarkRead) markRead(findUserById(a), b);
+        else markAllRead(findUserById(a), b);
+        break;
+    case JournalOp::MarkRangeRead:
+        in >> a >> b >> c;
+        flushNotifications();
+        markRangeRead(findUserById(a), b, c);
+        break;
+    case JournalOp::Remind:
+        in >> a >> b;
+        remind(findAssignmentById(a), b);
+        break;
+    case JournalOp::BulkBegin:
+        beginBulk();
+        break;
+    case JournalOp::BulkEnd:
+        endBulk();
+        break;
+    }
+    if (op != JournalOp::BulkBegin && op != JournalOp::BulkEnd) t_bulk.depth = bulkDepth;
 }
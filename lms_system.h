@@ -1,43 +1,307 @@
 
 #pragma once
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QWaitCondition>
+#include <atomic>
 #include "models.h"
+#include "mpsc_queue.h"
+#include "entity_index.h"
+#include "string_pool.h"
+#include "journal.h"
+#include "gradebook.h"
+#include "blob_store.h"
+#include "search_index.h"
+#include "prefix_trie.h"
+#include "timer_wheel.h"
 
-class LMSSystem {
-    // Storage (NO vectors) - fixed arrays
-    User* m_users[MAX_USERS];
-    int m_userCount;
+class QFile;
+class QLockFile;
+class QThread;
 
-    Course* m_courses[MAX_COURSES];
-    int m_courseCount;
+// What a type-ahead picker completes to (see LMSSystem::complete).
+enum class PickKind : quint8 {
+    Course,
+    Faculty,
+    Student
+};
+
+// One line of a batch grading request.
+struct GradeEntry {
+    int submissionId;
+    float grade;
+};
+
+// Thread-safe: any number of threads may call the API at once (service workers).
+// Locks are striped by id (LOCK_SHARDS stripes each):
+// - course lock: a course's student/assignment lists, their submissions, grades
+//   and gradebook columns, and its faculty
+// - user lock: a user's enrollments / assigned courses / grading queue and inbox
+// - creation locks: id generator + arena of one entity type, held across the
+//   journal append so ids replay in the same order
+// Lock order: course -> user -> creation -> notifications -> strings -> log -> journal.
+// The search update, pick and reminder locks come before all of them (never taken inside one).
+// Notifications are queued, not delivered: a mutation returns as soon as its
+// notices are on the delivery queue, and one delivery thread writes them into
+// inboxes in batches (see deliveryLoop).
+// Entity lists read from other threads go through readCourse()/readUser().
+class LMSSystem : public QObject {
+    Q_OBJECT
+
+    // All entity text (names, emails, titles, message templates) lives here once;
+    // declared first so it outlives every entity that points into it
+    StringPool m_strings;
+
+    // Storage (NO vectors) - per-type slab arenas, pointers stay stable
+    SlabArena<Admin> m_admins;
+    SlabArena<Faculty> m_faculty;
+    SlabArena<Student> m_students;
+    GrowArray<User*> m_users; // all roles, in creation order
+
+    SlabArena<Course> m_courses;
+    SlabArena<Assignment> m_assignments;
+    SlabArena<Submission> m_submissions;
+    SlabArena<Notification> m_notifs; // shared message payloads
+
+    // Id indexes (kept in sync with the arenas above)
+    EntityIndex<User> m_userIndex;
+    EntityIndex<Course> m_courseIndex;
+    EntityIndex<Assignment> m_assignmentIndex;
+    EntityIndex<Submission> m_submissionIndex;
+    PairIndex<Submission> m_submissionByStudent; // (student user id, assignment id)
+    QHash<QStringView, User*> m_emailIndex; // normalized email (interned) -> user
+
+    // Locks (see the class comment)
+    mutable QReadWriteLock m_courseLocks[LOCK_SHARDS];
+    mutable QReadWriteLock m_userLocks[LOCK_SHARDS];
+    mutable QReadWriteLock m_directoryLock; // m_users, m_emailIndex, user ids
+    QMutex m_courseCreateLock;
+    QMutex m_assignmentCreateLock;
+    QMutex m_submissionCreateLock;
+    mutable QMutex m_notifLock; // m_notifs, m_nextNotifId
+    QMutex m_logLock;           // journal append + queueing its notices, see logOp
+
+    // Every mutation holds this for read; checkpoint() takes it for write, so
+    // the snapshot sees no half-applied change. A checkpoint due while a
+    // mutation is running waits for the mutation to finish.
+    mutable QReadWriteLock m_checkpointLock;
+    std::atomic<bool> m_checkpointDue;
+    class MutationScope;
 
-    Assignment* m_assignments[MAX_ASSIGNMENTS];
-    int m_assignmentCount;
+    // Notification delivery: producers push, the delivery thread pops.
+    // A job is one user, the first `count` students of a course roster (taken
+    // when posted: rosters only grow), or an owned list of `count` users.
+    struct DeliveryJob {
+        std::atomic<DeliveryJob*> next{ nullptr };
+        Notification* notif = nullptr;
+        User* receiver = nullptr;
+        Course* course = nullptr;
+        User** receivers = nullptr;
+        int count = 0;
+    };
+    MpscQueue<DeliveryJob> m_deliveryQueue;
+    QThread* m_deliveryThread;
+    std::atomic<bool> m_deliveryStop;
+    std::atomic<bool> m_deliveryIdle;     // delivery thread is (about to be) asleep
+    std::atomic<qint64> m_jobsQueued;
+    std::atomic<qint64> m_jobsDelivered;
+    mutable QMutex m_deliveryLock;        // only for sleeping / waking
+    mutable QWaitCondition m_deliveryWake; // delivery thread waits for work
+    mutable QWaitCondition m_deliveryDone; // flushNotifications() waits for a pass
 
-    Submission* m_submissions[MAX_SUBMISSIONS];
-    int m_submissionCount;
+    // Deadline reminders: REMINDER_HOURS_BEFORE each due date, in a timer
+    // wheel that catches up from the assignment arena like the search index.
+    // The reminder thread advances it once a tick (see reminderLoop).
+    QThread* m_reminderThread;
+    std::atomic<bool> m_reminderStop;
+    QMutex m_reminderLock;         // m_reminders, m_remindedAssignments; also for sleeping
+    QWaitCondition m_reminderWake; // stop request
+    TimerWheel m_reminders;        // payload: assignment arena index * REMINDER_COUNT + reminder
+    int m_remindedAssignments;
 
-    Notification m_notifs[MAX_NOTIFS];
-    int m_notifCount;
+    // Columnar copy of every grade, for statistics (see gradebook.h)
+    Gradebook m_gradebook;
+
+    SessionCache m_sessions;
+
+    // Submission content, one blob per distinct file; reference counts are
+    // rebuilt from the submissions on load
+    BlobStore m_blobs;
+
+    // Search boxes. Entities are never renamed and the arenas only grow, so
+    // updateSearchIndex() just adds what was created since its last run.
+    SearchIndex m_search;      // courses and assignments
+    SearchIndex m_notifSearch; // notifications: others search only their inbox's part of it
+    QMutex m_searchUpdateLock; // held alone: creation locks are taken inside, one at a time
+    int m_searchedCourses;
+    int m_searchedAssignments;
+    int m_searchedNotifs;
+
+    // Type-ahead pickers, caught up from the arenas the same way
+    mutable QReadWriteLock m_pickLock;
+    PrefixTrie m_pickCourses;  // course id, name words
+    PrefixTrie m_pickFaculty;  // name words, email
+    PrefixTrie m_pickStudents; // name words, email
+    int m_pickedCourses;
+    int m_pickedUsers;
+
+    // Snapshot this state was loaded from; stays mapped because pooled
+    // strings and packed inboxes point straight into it
+    QFile* m_snapshotFile;
+    QLockFile* m_storeLock; // held while the store is open
+    quint64 m_snapshotSeq; // journal records up to this one are in the snapshot
+
+    // Write-ahead journal: every successful mutation appends one record
+    Journal m_journal;
+    QString m_checkpointPath; // snapshots are written to <this>.<generation>
+    quint64 m_snapshotGen;    // newest generation on disk
+    bool m_replaying;         // applying journal records: do not log them again
+    qint64 m_replayTimeMs;    // original time of the record being replayed
 
     // ID generators
     int m_nextUserId;
+    int m_nextAdminId;
+    int m_nextFacultyId;
+    int m_nextStudentId;
     int m_nextCourseId;
     int m_nextAssignId;
     int m_nextSubId;
     int m_nextNotifId;
+    std::atomic<int> m_deliveryCount;
+
+    // Interned notification templates (%1.. filled in when displayed)
+    Symbol m_tmplCourseAssigned;
+    Symbol m_tmplEnrolled;
+    Symbol m_tmplSubmitted;
+    Symbol m_tmplAssignmentPosted;
+    Symbol m_tmplGraded;
+    Symbol m_tmplGradedBatch;
+    Symbol m_tmplBulkEnrolled;
+    Symbol m_tmplBulkAssigned;
+    Symbol m_tmplBulkSubmitted;
+    Symbol m_tmplReminder;
+
+    QReadWriteLock& courseLock(int courseId) const;
+    QReadWriteLock& userLock(int userId) const;
+
+    template<typename T>
+    T* createUser(SlabArena<T>& arena, int& nextRoleId, JournalOp op,
+        const QString& name, const QString& email, const PasswordRecord& pass);
+    bool canAddUser(const QString& email) const; // directory lock held
+    void addUser(User* u);                       // directory lock held
+    void addToGradebook(Assignment* a);
+    void addToGradebook(Submission* sub);
+    void setGrade(Submission* sub, float grade);
+
+    Notification* newNotification(User* sender, Symbol tmpl, const Symbol* args = nullptr, int argCount = 0);
+    void enqueue(DeliveryJob* job);
+    DeliveryJob* noticeTo(Notification* n, User* receiver); // nullptr without a receiver
+    DeliveryJob* noticeToCourse(Notification* n, Course* c); // course lock held
+    void deliveryLoop();
+    void deliverBatch(DeliveryJob* const* jobs, int n);
+    void reminderLoop();
+    void removeOldSnapshots();
+    void remind(Assignment* a, int reminder);
+
+    QDateTime now() const;
+    void logOp(JournalOp op, const QByteArray& payload, DeliveryJob* const* notices = nullptr, int noticeCount = 0);
+    void applyJournalRecord(JournalOp op, quint8 flags, qint64 timeMs, QDataStream& in);
+
+    friend class SnapshotIO;
 
 public:
-    LMSSystem();
+    explicit LMSSystem(QObject* parent = nullptr);
     ~LMSSystem();
 
     void seedDemoData();
 
+    const StringPool& strings() const;
+
+    // Binary snapshot (see snapshot.h). load only works on an empty system;
+    // false if the file is missing, damaged or from another version.
+    bool saveSnapshot(const QString& path) const;
+    bool loadSnapshot(const QString& path);
+
+    // Replays the journal on top of the loaded snapshot, then keeps logging to it.
+    // checkpoint() writes the snapshot to a new generation, snapshotPath.<n+1>,
+    // and starts an empty journal; it also runs by itself once the journal
+    // passes JOURNAL_CHECKPOINT_BYTES. The loaded (mapped) file is never
+    // replaced, which Windows would refuse; older generations are removed.
+    bool openJournal(const QString& journalPath, const QString& snapshotPath,
+        FsyncPolicy policy = FsyncPolicy::Interval);
+    bool checkpoint();
+
+    // Snapshot + journal kept together in dir (created if missing):
+    // the newest snapshot generation that loads, then openJournal(). Callers
+    // seed an empty system themselves. False if another process (GUI or
+    // service) has the store open, or it could not be read.
+    // Submission blobs go to dir/SUBMISSION_STORE_DIR_NAME.
+    bool openStore(const QString& dir, FsyncPolicy policy = FsyncPolicy::Interval);
+    QString snapshotPath() const; // newest generation
+    static QString defaultStoreDir(); // per-user app data directory
+
+    // Batch of mutations (e.g. a CSV import) committed as one change:
+    // per-item signals are held back, enrollment/assignment/submission notices
+    // become one summary per course/faculty/assignment, and bulkImported() fires
+    // once at the end. Only for mutations made on the calling thread: other
+    // threads' changes meanwhile keep their own signals and notices.
+    void beginBulk();
+    void endBulk();
+
+    // Accounts (nullptr if the email is empty or already taken)
+    Admin* createAdmin(const QString& name, const QString& email, const PasswordRecord& pass);
+    Faculty* createFaculty(const QString& name, const QString& email, const PasswordRecord& pass);
+    Student* createStudent(const QString& name, const QString& email, const PasswordRecord& pass);
+
     // Auth
+    // login() runs the full password hash on the calling thread; the GUI
+    // looks the user up with findUserByEmail() and verifies on a worker instead.
     User* login(const QString& email, const QString& pass);
+    User* findUserByEmail(const QString& email) const;
+    SessionCache& sessions();
+    BlobStore& blobs();
+    static QString normalizeEmail(const QString& email);
 
     // Lookups
     Course* findCourseById(int courseId) const;
     User* findUserById(int userId) const;
+    Assignment* findAssignmentById(int assignmentId) const;
+    Submission* findSubmissionById(int submissionId) const;
+    const Notification* findNotificationById(int notifId) const;
+
+    // Run f() while the course's lists (students, assignments, submissions,
+    // faculty) or the user's lists (enrollments, courses, grading queue,
+    // inbox) cannot change under it. Needed only when other threads mutate.
+    template<typename F>
+    auto readCourse(const Course* c, F f) const {
+        QReadLocker lock(&courseLock(c->id()));
+        return f();
+    }
+
+    template<typename F>
+    auto readUser(const User* u, F f) const {
+        unpackInbox(u);
+        QReadLocker lock(&userLock(u->id()));
+        return f();
+    }
+
+    // Courses, assignments and notifications matching query, best first.
+    // Admins search every notification, others only their own inbox.
+    void search(const User* viewer, const QString& query, GrowArray<SearchHit>& out, int max = SEARCH_MAX_HITS);
+    void updateSearchIndex(); // slow the first time after a big load: run it on a worker early
+
+    // Type-ahead: ids of the courses / faculty / students with a key starting
+    // with prefix (case-insensitive), closest first, at most max, only those
+    // accept (optional) lets through. Returns how many were written to ids.
+    int complete(PickKind kind, const QString& prefix, int* ids, int max,
+        const std::function<bool(int)>& accept = {});
+    void updatePickIndex();
+
+    void unpackInbox(const User* u) const;
+    bool markRead(User* u, int index); // false if out of range
+    void markAllRead(User* u, int end = -1); // entries before end (default: all)
+    void markRangeRead(User* u, int begin, int end); // entries in [begin, end)
 
     // Safe casts by role
     Student* asStudent(User* u) const;
@@ -50,19 +314,45 @@ public:
 
     // Student actions
     bool studentEnroll(Student* student, int courseId);
-    Submission* studentSubmit(Student* student, int assignmentId, const QString& filePath);
+    // filePath is the name the student submitted; sha256/size name its content
+    // in blobs() when it went through put() (empty/0 for a bare path)
+    Submission* studentSubmit(Student* student, int assignmentId, const QString& filePath,
+        const QByteArray& sha256 = QByteArray(), qint64 size = 0);
+
+    // A student's own work, in O(their courses' assignments) whatever the
+    // campus size: the open assignments of the enrolled courses (not submitted
+    // yet, soonest due first, no due date last) and their submissions, oldest first.
+    int studentOpenAssignments(const Student* student, GrowArray<Assignment*>& out) const;
+    int studentSubmissions(const Student* student, GrowArray<Submission*>& out) const;
+    Submission* findSubmission(const Student* student, const Assignment* a) const;
 
     // Faculty actions
+    // due: see Assignment::parseDueDate; anything else is refused
     Assignment* facultyCreateAssignment(Faculty* faculty, int courseId,
         const QString& title, const QString& desc, const QString& due);
     bool facultyGradeSubmission(Faculty* faculty, int submissionId, float grade);
+    // Grades many submissions at once: ownership is checked once per course and
+    // each student gets one notification for the whole batch. Entries the
+    // faculty does not own (or unknown ids) are skipped. Returns how many were graded.
+    int facultyGradeBatch(Faculty* faculty, const GradeEntry* entries, int count);
+
+    // Grade statistics, straight from the gradebook columns
+    const Gradebook& gradebook() const;
+    GradeStats assignmentStats(Assignment* a) const;
+    GradeStats courseStats(Course* c) const;
 
     // Getters for UI lists
+    int userCount() const;
+    User* userAt(int i) const;
+
     int courseCount() const;
     Course* courseAt(int i) const;
 
-    int notifCount() const;
-    const Notification& notifAt(int i) const;
+    int notifCount() const;    // distinct messages (per-user lists: User::inbox())
+    int deliveryCount() const; // inbox entries across all users
+
+    // Waits until everything queued so far is in its inboxes.
+    void flushNotifications() const;
 
     int assignmentCount() const;
     Assignment* assignmentAt(int i) const;
@@ -71,5 +361,32 @@ public:
     Submission* submissionAt(int i) const;
 
     // Notifications
+    // Broadcasts store the text once and add a small entry to each inbox.
+    // Delivery is asynchronous: inboxes fill in shortly after the call returns
+    // and notificationsDelivered() fires from the delivery thread.
     void sendNotif(User* sender, User* receiver, const QString& msg);
+    void broadcastNotif(User* sender, User* const* receivers, int count, const QString& msg);
+    void broadcastToCourse(User* sender, Course* c, const QString& msg);
+
+    // Deadline reminders: starts the reminder thread (once everything is
+    // loaded: sent reminders are journaled). Reminders whose
+    // time passed while nothing was running are skipped, not sent late.
+    void startReminders();
+    // One reminder tick: schedules new assignments, sends what came due by
+    // nowMs. Returns the reminders sent (one per assignment and reminder time).
+    int sendDueReminders(qint64 nowMs);
+
+signals:
+    // Fine-grained change events, emitted after the change is applied.
+    // Views update only the affected rows instead of rebuilding everything.
+    void userAdded(User* u);
+    void courseAdded(Course* c);
+    void facultyAssigned(Course* c, Faculty* f);
+    void studentEnrolled(Student* s, Course* c);
+    void assignmentPosted(Assignment* a);
+    void submissionAdded(Submission* sub);
+    void submissionGraded(Submission* sub);
+    void submissionsGraded(Faculty* f, int count); // once per facultyGradeBatch
+    void notificationsDelivered(); // once per delivery pass (delivery thread), not per recipient
+    void bulkImported();           // after endBulk(): reload whatever is shown
 };
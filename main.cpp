@@ -1,6 +1,13 @@
-
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QFile>
+#include <QMessageBox>
+#include <QTextStream>
+#include <QTimer>
+#include <QtConcurrent>
+#include <csignal>
+#include <cstring>
+#include "http_server.h"
 #include "mainwindow.h"
 
 static QString loadTextFile(const QString& path) {
@@ -9,13 +16,91 @@ static QString loadTextFile(const QString& path) {
     return QString::fromUtf8(f.readAll());
 }
 
+static bool wantsService(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++)
+        if (std::strcmp(argv[i], "--serve") == 0) return true;
+    return false;
+}
+
+// set by SIGINT/SIGTERM, polled from the event loop (a handler may not touch Qt)
+static volatile std::sig_atomic_t g_stop = 0;
+static void requestStop(int) { g_stop = 1; }
+
+// Headless mode: BahriaLMS --serve [--port N] [--threads N] [--data DIR]
+// JSON over HTTP on localhost against the same snapshot + journal as the GUI.
+static int runService(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("BahriaLMS");
+
+    QCommandLineParser args;
+    args.setApplicationDescription("Bahria LMS headless service");
+    args.addHelpOption();
+    args.addOption(QCommandLineOption("serve", "Run the HTTP service instead of the GUI"));
+    args.addOption(QCommandLineOption("port", "Port on localhost", "n", QString::number(SERVICE_DEFAULT_PORT)));
+    args.addOption(QCommandLineOption("threads", "Worker threads (default: one per core)", "n"));
+    args.addOption(QCommandLineOption("data", "Snapshot and journal directory", "dir"));
+    args.process(app);
+
+    QTextStream out(stdout);
+    LMSSystem sys;
+    QString dir = args.isSet("data") ? args.value("data") : LMSSystem::defaultStoreDir();
+    if (!sys.openStore(dir)) {
+        QTextStream(stderr) << "cannot open " << dir << " (in use by another BahriaLMS?)\n";
+        return 1;
+    }
+    if (sys.userCount() == 0)
+        sys.seedDemoData();
+    sys.startReminders();
+
+    LmsService service(sys);
+    int threads = args.isSet("threads") ? args.value("threads").toInt() : QThread::idealThreadCount();
+    int rc = 0;
+    {
+        HttpServer server(service, threads);
+        if (!server.listen(QHostAddress::LocalHost, quint16(args.value("port").toInt()))) {
+            QTextStream(stderr) << "cannot listen: " << server.errorString() << "\n";
+            return 1;
+        }
+        out << "serving on http://127.0.0.1:" << server.serverPort() << " with " << qMax(1, threads) << " worker threads\n";
+        out.flush();
+
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        QTimer stopPoll;
+        QObject::connect(&stopPoll, &QTimer::timeout, [&app]() { if (g_stop) app.quit(); });
+        stopPoll.start(200);
+
+        // drop unreferenced blobs, compress cold ones
+        QFuture<BlobStore::Maintenance> maintenance = QtConcurrent::run([&sys]() { return sys.blobs().maintain(); });
+
+        rc = app.exec();
+        sys.blobs().stopMaintenance();
+        maintenance.waitForFinished();
+    } // server gone: every worker thread has finished its last request
+
+    // fold the journal into a fresh snapshot so the next start replays nothing
+    if (!sys.checkpoint()) QTextStream(stderr) << "could not save " << sys.snapshotPath() << "\n";
+    return rc;
+}
+
 int main(int argc, char* argv[]) {
+    if (wantsService(argc, argv)) return runService(argc, argv);
+
     QApplication a(argc, argv);
+    a.setApplicationName("BahriaLMS"); // app data directory name (snapshot)
 
     // Apply theme (global)
     a.setStyleSheet(loadTextFile(":/theme/bahria.qss"));
 
-    MainWindow w;
+    // last snapshot + journal tail
+    LMSSystem sys;
+    if (!sys.openStore(LMSSystem::defaultStoreDir())) {
+        QMessageBox::critical(nullptr, "BahriaLMS", "Could not open the data in " + LMSSystem::defaultStoreDir()
+            + ".\nIt may be in use by another BahriaLMS window or service.");
+        return 1;
+    }
+
+    MainWindow w(sys);
     w.show();
     return a.exec();
 }
@@ -7,6 +7,27 @@
 #include <QMessageBox>
 #include <QFrame>
 #include <QLabel>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QListView>
+#include <QFileDialog>
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include "csv_import.h"
+#include "similarity.h"
+
+// Lazy list view: uniform row height lets Qt skip measuring rows that are
+// not on screen, and the model feeds rows page by page via fetchMore().
+static QListView* makeLazyListView(QAbstractItemModel* model)
+{
+    QListView* v = new QListView();
+    v->setModel(model);
+    v->setUniformItemSizes(true);
+    v->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    v->setSelectionMode(QAbstractItemView::SingleSelection);
+    return v;
+}
 
 // Helper for showing role in message box
 static QString roleToString(Role r)
@@ -16,10 +37,26 @@ static QString roleToString(Role r)
     return "Student";
 }
 
-MainWindow::MainWindow(QWidget* parent)
-    : QMainWindow(parent), m_current(nullptr)
+MainWindow::MainWindow(LMSSystem& sys, QWidget* parent)
+    : QMainWindow(parent), m_sys(sys), m_current(nullptr)
 {
-    m_sys.seedDemoData();
+    // demo data on first run
+    if (m_sys.userCount() == 0)
+        m_sys.seedDemoData();
+    m_sys.startReminders();
+
+    m_notifModel = new NotificationListModel(m_sys, this);
+    m_submissionModel = new SubmissionListModel(this);
+    m_ingestor = new SubmissionIngestor(m_sys.blobs(), this);
+
+    // drop unreferenced blobs, compress cold ones (in the background, it walks the whole store)
+    m_blobMaintenance = QtConcurrent::run([this]() { return m_sys.blobs().maintain(); });
+
+    // first search / keystroke would otherwise index everything loaded above
+    QThreadPool::globalInstance()->start([this]() {
+        m_sys.updateSearchIndex();
+        m_sys.updatePickIndex();
+    });
 
     // ---------------------------
     // 1) Create stacked pages
@@ -67,6 +104,16 @@ MainWindow::MainWindow(QWidget* parent)
     setWindowTitle("Bahria LMS (No Vectors)");
     resize(900, 600);
 
+    connect(&m_sys, &LMSSystem::assignmentPosted, this, &MainWindow::onAssignmentPosted);
+    connect(&m_sys, &LMSSystem::submissionAdded, this, &MainWindow::onSubmissionAdded);
+    connect(&m_sys, &LMSSystem::submissionGraded, this, &MainWindow::onSubmissionGraded);
+    connect(&m_sys, &LMSSystem::submissionsGraded, this, &MainWindow::onSubmissionsGraded);
+    connect(&m_sys, &LMSSystem::notificationsDelivered, this, &MainWindow::onNotificationsDelivered);
+    connect(&m_sys, &LMSSystem::bulkImported, this, &MainWindow::onBulkImported);
+    connect(m_ingestor, &SubmissionIngestor::progress, this, &MainWindow::onUploadProgress);
+    connect(m_ingestor, &SubmissionIngestor::finished, this, &MainWindow::onUploadFinished);
+    connect(m_ingestor, &SubmissionIngestor::failed, this, &MainWindow::onUploadFailed);
+
     refreshAllCombos();
     stack->setCurrentWidget(loginPage);
 }
@@ -88,7 +135,7 @@ QWidget* MainWindow::buildLoginPage()
     passEdit->setPlaceholderText("Password (admin / 1234)");
     passEdit->setEchoMode(QLineEdit::Password);
 
-    QPushButton* loginBtn = new QPushButton("Login");
+    loginBtn = new QPushButton("Login");
     loginBtn->setProperty("variant", "primary"); // optional for QSS theme
     connect(loginBtn, &QPushButton::clicked, this, &MainWindow::doLogin);
 
@@ -112,6 +159,7 @@ QWidget* MainWindow::buildAdminPage()
     QLabel* title = new QLabel("Admin Dashboard");
     title->setStyleSheet("font-size: 20px; font-weight: bold;");
     v->addWidget(title);
+    v->addWidget(buildSearchBox(adminSearchEdit, adminSearchResults));
 
     // Create course
     QGroupBox* g1 = new QGroupBox("Create Course");
@@ -131,8 +179,8 @@ QWidget* MainWindow::buildAdminPage()
     QGroupBox* g2 = new QGroupBox("Assign Faculty to Course");
     QHBoxLayout* h2 = new QHBoxLayout(g2);
 
-    courseSelectAdmin = new QComboBox();
-    facultySelectAdmin = new QComboBox();
+    courseSelectAdmin = new EntityPicker(m_sys, PickKind::Course);
+    facultySelectAdmin = new EntityPicker(m_sys, PickKind::Faculty);
 
     assignFacultyBtn = new QPushButton("Assign");
     assignFacultyBtn->setProperty("variant", "primary"); // optional for QSS theme
@@ -144,9 +192,23 @@ QWidget* MainWindow::buildAdminPage()
     h2->addWidget(facultySelectAdmin);
     h2->addWidget(assignFacultyBtn);
 
+    // Registrar CSV import (format in csv_import.h)
+    QGroupBox* gImport = new QGroupBox("Bulk Import (CSV)");
+    QHBoxLayout* hImport = new QHBoxLayout(gImport);
+
+    importCsvBtn = new QPushButton("Import CSV...");
+    importCsvBtn->setProperty("variant", "primary"); // optional for QSS theme
+    connect(importCsvBtn, &QPushButton::clicked, this, &MainWindow::adminImportCsv);
+
+    importStatus = new QLabel("user / course / enroll rows");
+
+    hImport->addWidget(importCsvBtn);
+    hImport->addWidget(importStatus, 1);
+
     // Notifications
-    adminNotifs = new QListWidget();
+    adminNotifs = makeLazyListView(m_notifModel);
     QGroupBox* g3 = new QGroupBox("Notifications");
+    adminNotifsBox = g3;
     QVBoxLayout* h3 = new QVBoxLayout(g3);
     h3->addWidget(adminNotifs);
 
@@ -156,6 +218,7 @@ QWidget* MainWindow::buildAdminPage()
 
     v->addWidget(g1);
     v->addWidget(g2);
+    v->addWidget(gImport);
     v->addWidget(g3);
     v->addWidget(logoutBtn1);
 
@@ -170,11 +233,16 @@ QWidget* MainWindow::buildFacultyPage()
     QLabel* title = new QLabel("Faculty Dashboard");
     title->setStyleSheet("font-size: 20px; font-weight: bold;");
     v->addWidget(title);
+    v->addWidget(buildSearchBox(facultySearchEdit, facultySearchResults));
 
     QGroupBox* g1 = new QGroupBox("Post Assignment");
     QVBoxLayout* vg1 = new QVBoxLayout(g1);
 
-    courseSelectFaculty = new QComboBox();
+    courseSelectFaculty = new EntityPicker(m_sys, PickKind::Course);
+    courseSelectFaculty->setFilter([this](int courseId) {
+        Course* c = m_sys.findCourseById(courseId);
+        return c && m_current && m_sys.readCourse(c, [c]() { return c->faculty(); }) == m_current;
+    });
 
     assTitleEdit = new QLineEdit();
     assTitleEdit->setPlaceholderText("Title");
@@ -183,7 +251,7 @@ QWidget* MainWindow::buildFacultyPage()
     assDescEdit->setPlaceholderText("Description");
 
     assDueEdit = new QLineEdit();
-    assDueEdit->setPlaceholderText("Due Date (YYYY-MM-DD)");
+    assDueEdit->setPlaceholderText("Due Date (YYYY-MM-DD or YYYY-MM-DD hh:mm)");
 
     postAssBtn = new QPushButton("Post");
     postAssBtn->setProperty("variant", "primary"); // optional for QSS theme
@@ -196,10 +264,10 @@ QWidget* MainWindow::buildFacultyPage()
     vg1->addWidget(assDueEdit);
     vg1->addWidget(postAssBtn);
 
-    QGroupBox* g2 = new QGroupBox("Grade Submission");
+    QGroupBox* g2 = new QGroupBox("Grade Submission (your courses)");
     QHBoxLayout* hg2 = new QHBoxLayout(g2);
 
-    submissionSelect = new QComboBox();
+    submissionView = makeLazyListView(m_submissionModel);
 
     gradeSpin = new QSpinBox();
     gradeSpin->setRange(0, 100);
@@ -208,14 +276,54 @@ QWidget* MainWindow::buildFacultyPage()
     gradeBtn->setProperty("variant", "primary"); // optional for QSS theme
     connect(gradeBtn, &QPushButton::clicked, this, &MainWindow::facultyGrade);
 
-    hg2->addWidget(new QLabel("Submission:"));
-    hg2->addWidget(submissionSelect);
-    hg2->addWidget(new QLabel("Grade:"));
-    hg2->addWidget(gradeSpin);
-    hg2->addWidget(gradeBtn);
-
-    facultyNotifs = new QListWidget();
+    saveSubmissionBtn = new QPushButton("Save File As...");
+    connect(saveSubmissionBtn, &QPushButton::clicked, this, &MainWindow::facultySaveSubmission);
+
+    importGradesBtn = new QPushButton("Import Grades CSV...");
+    connect(importGradesBtn, &QPushButton::clicked, this, &MainWindow::facultyImportGrades);
+
+    QVBoxLayout* pick = new QVBoxLayout();
+    pick->addWidget(new QLabel("Grade:"));
+    pick->addWidget(gradeSpin);
+    pick->addWidget(gradeBtn);
+    pick->addWidget(saveSubmissionBtn);
+    pick->addWidget(importGradesBtn);
+    pick->addStretch();
+
+    hg2->addWidget(submissionView, 1);
+    hg2->addLayout(pick);
+
+    // statistics for the course picked above, from the columnar gradebook
+    QGroupBox* gStats = new QGroupBox("Course Statistics");
+    QVBoxLayout* vStats = new QVBoxLayout(gStats);
+    courseStatsView = new QPlainTextEdit();
+    courseStatsView->setReadOnly(true);
+    courseStatsView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    courseStatsView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    vStats->addWidget(courseStatsView);
+    connect(courseSelectFaculty, &EntityPicker::currentIdChanged, this, &MainWindow::refreshCourseStats);
+
+    // copied work within one assignment of the course picked above, most similar first
+    QGroupBox* gSim = new QGroupBox("Similarity Check");
+    QVBoxLayout* vSim = new QVBoxLayout(gSim);
+    similarityAssignSelect = new QComboBox();
+    checkSimilarityBtn = new QPushButton("Check");
+    connect(checkSimilarityBtn, &QPushButton::clicked, this, &MainWindow::facultyCheckSimilarity);
+    QHBoxLayout* simRow = new QHBoxLayout();
+    simRow->addWidget(new QLabel("Assignment:"));
+    simRow->addWidget(similarityAssignSelect, 1);
+    simRow->addWidget(checkSimilarityBtn);
+    similarityView = new QPlainTextEdit();
+    similarityView->setReadOnly(true);
+    similarityView->setLineWrapMode(QPlainTextEdit::NoWrap);
+    similarityView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    vSim->addLayout(simRow);
+    vSim->addWidget(similarityView);
+    connect(courseSelectFaculty, &EntityPicker::currentIdChanged, this, &MainWindow::refreshSimilarityAssignments);
+
+    facultyNotifs = makeLazyListView(m_notifModel);
     QGroupBox* g3 = new QGroupBox("Notifications");
+    facultyNotifsBox = g3;
     QVBoxLayout* vg3 = new QVBoxLayout(g3);
     vg3->addWidget(facultyNotifs);
 
@@ -225,6 +333,8 @@ QWidget* MainWindow::buildFacultyPage()
 
     v->addWidget(g1);
     v->addWidget(g2);
+    v->addWidget(gStats);
+    v->addWidget(gSim);
     v->addWidget(g3);
     v->addWidget(logoutBtn2);
 
@@ -239,11 +349,12 @@ QWidget* MainWindow::buildStudentPage()
     QLabel* title = new QLabel("Student Dashboard");
     title->setStyleSheet("font-size: 20px; font-weight: bold;");
     v->addWidget(title);
+    v->addWidget(buildSearchBox(studentSearchEdit, studentSearchResults));
 
     QGroupBox* g1 = new QGroupBox("Enroll Course");
     QHBoxLayout* hg1 = new QHBoxLayout(g1);
 
-    courseSelectStudent = new QComboBox();
+    courseSelectStudent = new EntityPicker(m_sys, PickKind::Course);
 
     enrollBtn = new QPushButton("Enroll");
     enrollBtn->setProperty("variant", "primary"); // optional for QSS theme
@@ -258,19 +369,41 @@ QWidget* MainWindow::buildStudentPage()
     assignmentSelectStudent = new QComboBox();
 
     filePathEdit = new QLineEdit();
-    filePathEdit->setPlaceholderText("File path (demo). Example: D:/work/a1.pdf");
+    filePathEdit->setPlaceholderText("File to submit. Example: D:/work/a1.pdf");
+
+    browseFileBtn = new QPushButton("Browse...");
+    connect(browseFileBtn, &QPushButton::clicked, this, &MainWindow::studentBrowseFile);
+
+    QHBoxLayout* fileRow = new QHBoxLayout();
+    fileRow->addWidget(filePathEdit, 1);
+    fileRow->addWidget(browseFileBtn);
 
     submitBtn = new QPushButton("Submit");
     submitBtn->setProperty("variant", "primary"); // optional for QSS theme
     connect(submitBtn, &QPushButton::clicked, this, &MainWindow::studentSubmit);
 
+    // upload progress of this student's files (all of them together)
+    uploadProgress = new QProgressBar();
+    uploadProgress->setRange(0, 1000);
+    uploadProgress->setTextVisible(false);
+    uploadProgress->hide();
+    uploadStatus = new QLabel("");
+
     vg2->addWidget(new QLabel("Assignment:"));
     vg2->addWidget(assignmentSelectStudent);
-    vg2->addWidget(filePathEdit);
+    vg2->addLayout(fileRow);
     vg2->addWidget(submitBtn);
+    vg2->addWidget(uploadProgress);
+    vg2->addWidget(uploadStatus);
 
-    studentNotifs = new QListWidget();
+    QGroupBox* gWork = new QGroupBox("My Submissions");
+    QVBoxLayout* vWork = new QVBoxLayout(gWork);
+    studentWorkView = new QListWidget();
+    vWork->addWidget(studentWorkView);
+
+    studentNotifs = makeLazyListView(m_notifModel);
     QGroupBox* g3 = new QGroupBox("Notifications");
+    studentNotifsBox = g3;
     QVBoxLayout* vg3 = new QVBoxLayout(g3);
     vg3->addWidget(studentNotifs);
 
@@ -280,6 +413,7 @@ QWidget* MainWindow::buildStudentPage()
 
     v->addWidget(g1);
     v->addWidget(g2);
+    v->addWidget(gWork);
     v->addWidget(g3);
     v->addWidget(logoutBtn3);
 
@@ -287,72 +421,279 @@ QWidget* MainWindow::buildStudentPage()
 }
 
 // ------------------------------ REFRESH UI ------------------------------
+static QString courseItemText(const Course* c)
+{
+    return QString::number(c->id()) + " - " + c->name();
+}
+
+static QString assignmentItemText(const Assignment* a)
+{
+    return QString::number(a->id()) + " - " + a->title() +
+        " (Course: " + a->course()->name() + (a->dueMs() > 0 ? ", due " + a->dueDate() : QString()) + ")";
+}
+
+// Full rebuild: at startup and after a bulk import (onBulkImported). Otherwise
+// the LMSSystem change signals below keep every widget in sync row by row.
 void MainWindow::refreshAllCombos()
 {
-    courseSelectAdmin->clear();
-    courseSelectStudent->clear();
-    courseSelectFaculty->clear();
+    // (course and people pickers complete from LMSSystem's tries: nothing to load)
+
+    refreshStudentWork();
+
+    refreshNotifications();
+}
+
+void MainWindow::refreshNotifications()
+{
+    // Only the logged-in user's own inbox, loaded page by page by the views.
+    // The submissions queue is the faculty member's own (empty for others).
+    m_notifModel->setUser(m_current);
+    m_submissionModel->setFaculty(m_sys.asFaculty(m_current));
+
+    updateUnreadTitle();
+}
+
+void MainWindow::updateUnreadTitle()
+{
+    if (!m_current) return;
+    notifBoxFor(m_current->role())->setTitle(
+        "Notifications (" + QString::number(m_sys.readUser(m_current, [this]() { return m_current->inbox().unreadCount(); })) + " unread)");
+}
 
-    for (int i = 0; i < m_sys.courseCount(); i++) {
-        Course* c = m_sys.courseAt(i);
-        if (!c) continue;
+static QString statsText(const GradeStats& s)
+{
+    QString t = QString("Submissions: %1, graded: %2\n").arg(s.submissions).arg(s.graded);
+    if (s.graded == 0) return t;
+
+    t += QString("Mean %1  SD %2  Min %3  Max %4\n")
+        .arg(s.mean, 0, 'f', 1).arg(s.stddev, 0, 'f', 1).arg(s.min).arg(s.max);
+    t += QString("P25 %1  Median %2  P75 %3  P90 %4\n")
+        .arg(s.p25).arg(s.median).arg(s.p75).arg(s.p90);
+
+    int peak = 1;
+    for (int b = 0; b < GRADE_HISTOGRAM_BUCKETS; b++) peak = qMax(peak, s.histogram[b]);
+    for (int b = 0; b < GRADE_HISTOGRAM_BUCKETS; b++) {
+        int lo = b * 10;
+        int hi = b == GRADE_HISTOGRAM_BUCKETS - 1 ? 100 : lo + 9;
+        QString range = QString("%1-%2").arg(lo, 2).arg(hi, -3);
+        t += range + " |" + QString(s.histogram[b] * 40 / peak, '#') + " " + QString::number(s.histogram[b]) + "\n";
+    }
+    return t;
+}
 
-        QString item = QString::number(c->id()) + " - " + c->name();
-        courseSelectAdmin->addItem(item, c->id());
-        courseSelectStudent->addItem(item, c->id());
-        courseSelectFaculty->addItem(item, c->id());
+void MainWindow::refreshCourseStats()
+{
+    Faculty* f = m_sys.asFaculty(m_current);
+    Course* c = m_sys.findCourseById(courseSelectFaculty->currentId());
+    if (!f || !c) {
+        courseStatsView->clear();
+        return;
+    }
+    if (c->faculty() != f) {
+        courseStatsView->setPlainText("Statistics are shown for your own courses only.");
+        return;
     }
 
-    // Faculty list for admin (demo)
-    facultySelectAdmin->clear();
-    facultySelectAdmin->addItem("faculty@lms.com (Dr. Ahmed)", 0);
+    // whole course first, then one short line per assignment
+    QString t = c->name() + "\n" + statsText(m_sys.courseStats(c));
+    for (int i = 0; i < c->assignmentCount(); i++) {
+        Assignment* a = c->assignmentAt(i);
+        GradeStats s = m_sys.assignmentStats(a);
+        t += "\n" + a->title() + QString(": %1 submitted, %2 graded").arg(s.submissions).arg(s.graded);
+        if (s.graded > 0)
+            t += QString(", mean %1, median %2").arg(s.mean, 0, 'f', 1).arg(s.median);
+    }
+    courseStatsView->setPlainText(t);
+}
 
-    // Assignment list for student
+void MainWindow::refreshSimilarityAssignments()
+{
+    similarityAssignSelect->clear();
+    similarityView->clear();
+    Course* c = m_sys.findCourseById(courseSelectFaculty->currentId());
+    if (!c) return;
+    m_sys.readCourse(c, [this, c]() {
+        for (int i = 0; i < c->assignmentCount(); i++)
+            similarityAssignSelect->addItem(assignmentItemText(c->assignmentAt(i)), c->assignmentAt(i)->id());
+    });
+}
+
+// Only the logged-in student's courses and submissions are read: the cost
+// does not grow with the campus.
+void MainWindow::refreshStudentWork()
+{
+    int picked = assignmentSelectStudent->currentData().toInt();
     assignmentSelectStudent->clear();
-    for (int i = 0; i < m_sys.assignmentCount(); i++) {
-        Assignment* a = m_sys.assignmentAt(i);
-        if (!a || !a->course()) continue;
+    studentWorkView->clear();
+    Student* s = m_sys.asStudent(m_current);
+    if (!s) return;
 
-        QString item = QString::number(a->id()) + " - " + a->title() +
-            " (Course: " + a->course()->name() + ")";
-        assignmentSelectStudent->addItem(item, a->id());
+    GrowArray<Assignment*> open;
+    m_sys.studentOpenAssignments(s, open);
+    for (int i = 0; i < open.count(); i++)
+        assignmentSelectStudent->addItem(assignmentItemText(open[i]), open[i]->id());
+    int i = assignmentSelectStudent->findData(picked);
+    if (i >= 0) assignmentSelectStudent->setCurrentIndex(i);
+
+    // newest first
+    GrowArray<Submission*> mine;
+    m_sys.studentSubmissions(s, mine);
+    for (int j = mine.count() - 1; j >= 0; j--) {
+        const Submission* sub = mine[j];
+        const Assignment* a = sub->assignment();
+        QString item = a->title() + " (" + a->course()->name() + ") - " +
+            (sub->status() == SubmissionStatus::Graded ? "graded: " + QString::number(sub->grade()) : QString("submitted"));
+        studentWorkView->addItem(item);
     }
+    if (mine.isEmpty()) studentWorkView->addItem("No submissions yet.");
+}
 
-    // Submissions list for faculty
-    submissionSelect->clear();
-    for (int i = 0; i < m_sys.submissionCount(); i++) {
-        Submission* s = m_sys.submissionAt(i);
-        if (!s || !s->assignment() || !s->student()) continue;
+// ------------------------------ SEARCH ------------------------------
+QGroupBox* MainWindow::buildSearchBox(QLineEdit*& edit, QListWidget*& results)
+{
+    QGroupBox* g = new QGroupBox("Search");
+    QVBoxLayout* vg = new QVBoxLayout(g);
+
+    edit = new QLineEdit();
+    edit->setPlaceholderText("Courses, assignments, notifications...");
+    edit->setClearButtonEnabled(true);
+
+    results = new QListWidget();
+    results->setMaximumHeight(160);
+    results->hide();
+
+    // the index answers well under a millisecond: search on every keystroke
+    QLineEdit* e = edit;
+    QListWidget* r = results;
+    connect(e, &QLineEdit::textChanged, this, [this, e, r]() { runSearch(e, r); });
+    connect(r, &QListWidget::itemActivated, this, &MainWindow::openSearchHit);
+
+    vg->addWidget(edit);
+    vg->addWidget(results);
+    return g;
+}
 
-        QString item = QString::number(s->id()) + " - " + s->student()->name() +
-            " -> " + s->assignment()->title();
-        submissionSelect->addItem(item, s->id());
+void MainWindow::runSearch(QLineEdit* edit, QListWidget* results)
+{
+    results->clear();
+    QString query = edit->text();
+    if (!m_current || query.trimmed().isEmpty()) {
+        results->hide();
+        return;
     }
 
-    refreshNotifications();
+    GrowArray<SearchHit> hits;
+    m_sys.search(m_current, query, hits);
+    for (int i = 0; i < hits.count(); i++) {
+        QString text;
+        if (hits[i].kind == SearchKind::Course) {
+            Course* c = m_sys.findCourseById(hits[i].id);
+            if (c) text = "Course: " + courseItemText(c);
+        } else if (hits[i].kind == SearchKind::Assignment) {
+            Assignment* a = m_sys.findAssignmentById(hits[i].id);
+            if (a) text = "Assignment: " + assignmentItemText(a);
+        } else {
+            const Notification* n = m_sys.findNotificationById(hits[i].id);
+            if (n) text = "Notification: " + n->time().toString("yyyy-MM-dd hh:mm") + "  " + n->message();
+        }
+        if (text.isEmpty()) continue;
+        QListWidgetItem* item = new QListWidgetItem(text, results);
+        item->setData(Qt::UserRole, hits[i].id);
+        item->setData(Qt::UserRole + 1, int(hits[i].kind));
+    }
+    if (results->count() == 0) results->addItem("No matches.");
+    results->show();
 }
 
-void MainWindow::refreshNotifications()
+// picks the hit in this dashboard's own controls
+void MainWindow::openSearchHit(QListWidgetItem* item)
 {
-    adminNotifs->clear();
-    facultyNotifs->clear();
-    studentNotifs->clear();
+    if (!item || !item->data(Qt::UserRole).isValid()) return;
+    int id = item->data(Qt::UserRole).toInt();
+    SearchKind kind = SearchKind(item->data(Qt::UserRole + 1).toInt());
+
+    int courseId = -1;
+    if (kind == SearchKind::Course) {
+        courseId = id;
+    } else if (kind == SearchKind::Assignment) {
+        Assignment* a = m_sys.findAssignmentById(id);
+        if (!a || !a->course()) return;
+        courseId = a->course()->id();
+        int i = assignmentSelectStudent->findData(id);
+        if (m_sys.asStudent(m_current) && i >= 0) assignmentSelectStudent->setCurrentIndex(i);
+    } else {
+        return; // the message is the whole hit
+    }
 
-    for (int i = 0; i < m_sys.notifCount(); i++) {
-        const Notification& n = m_sys.notifAt(i);
-        if (!n.receiver()) continue;
+    EntityPicker* picker = m_sys.asAdmin(m_current) ? courseSelectAdmin
+        : m_sys.asFaculty(m_current) ? courseSelectFaculty : courseSelectStudent;
+    picker->setCurrentId(courseId);
+    if (kind == SearchKind::Assignment && m_sys.asFaculty(m_current)) {
+        int j = similarityAssignSelect->findData(id);
+        if (j >= 0) similarityAssignSelect->setCurrentIndex(j);
+    }
+}
 
-        QString line = n.time().toString("yyyy-MM-dd hh:mm") + "  " + n.message();
+// ------------------------------ CHANGE EVENTS ------------------------------
+void MainWindow::onAssignmentPosted(Assignment* a)
+{
+    if (!a->course()) return;
+    if (m_sys.asStudent(m_current)) refreshStudentWork();
+    if (m_sys.asFaculty(m_current) && a->course()->faculty() == m_current) {
+        refreshCourseStats();
+        if (a->course()->id() == courseSelectFaculty->currentId())
+            similarityAssignSelect->addItem(assignmentItemText(a), a->id());
+    }
+}
 
-        if (n.receiver()->role() == Role::Admin)   adminNotifs->addItem(line);
-        if (n.receiver()->role() == Role::Faculty) facultyNotifs->addItem(line);
-        if (n.receiver()->role() == Role::Student) studentNotifs->addItem(line);
+void MainWindow::onSubmissionAdded(Submission* sub)
+{
+    Faculty* f = m_sys.asFaculty(m_current);
+    Course* c = sub->assignment() ? sub->assignment()->course() : nullptr;
+    if (f && c && c->faculty() == f) {
+        m_submissionModel->submissionAppended();
+        refreshCourseStats();
     }
 }
 
+void MainWindow::onSubmissionGraded(Submission* sub)
+{
+    if (m_current && sub->student() == m_current) refreshStudentWork();
+    if (m_sys.asFaculty(m_current)) {
+        m_submissionModel->submissionChanged();
+        refreshCourseStats();
+    }
+}
+
+void MainWindow::onSubmissionsGraded(Faculty* f, int count)
+{
+    Q_UNUSED(count);
+    if (m_sys.asStudent(m_current)) refreshStudentWork();
+    // one repaint for the whole batch
+    if (f && m_sys.asFaculty(m_current) == f) {
+        m_submissionModel->submissionChanged();
+        refreshCourseStats();
+    }
+}
+
+void MainWindow::onNotificationsDelivered()
+{
+    // O(1) per send/broadcast: only rows new to the current user's inbox are inserted
+    if (!m_current) return;
+    m_notifModel->syncWithInbox();
+    updateUnreadTitle();
+}
+
+QGroupBox* MainWindow::notifBoxFor(Role r) const
+{
+    if (r == Role::Admin)   return adminNotifsBox;
+    if (r == Role::Faculty) return facultyNotifsBox;
+    return studentNotifsBox;
+}
+
 void MainWindow::gotoRoleHome()
 {
-    refreshAllCombos();
+    refreshNotifications();
 
     if (!m_current) {
         stack->setCurrentWidget(loginPage);
@@ -360,8 +701,18 @@ void MainWindow::gotoRoleHome()
     }
 
     if (m_current->role() == Role::Admin) stack->setCurrentWidget(adminPage);
-    else if (m_current->role() == Role::Faculty) stack->setCurrentWidget(facultyPage);
-    else stack->setCurrentWidget(studentPage);
+    else if (m_current->role() == Role::Faculty) {
+        // start on the faculty member's first course
+        Faculty* f = m_sys.asFaculty(m_current);
+        Course* first = m_sys.readUser(f, [f]() { return f->assignedCount() > 0 ? f->assignedAt(0) : nullptr; });
+        courseSelectFaculty->setCurrentId(first ? first->id() : -1);
+        refreshCourseStats();
+        stack->setCurrentWidget(facultyPage);
+    }
+    else {
+        refreshStudentWork();
+        stack->setCurrentWidget(studentPage);
+    }
 }
 
 // ------------------------------ SLOTS ------------------------------
@@ -369,13 +720,50 @@ void MainWindow::doLogin()
 {
     loginStatus->setText("");
 
-    User* u = m_sys.login(emailEdit->text().trimmed(), passEdit->text());
+    QString pass = passEdit->text();
+    User* u = m_sys.findUserByEmail(emailEdit->text());
     if (!u) {
         loginStatus->setText("Invalid email or password.");
         return;
     }
 
+    // Re-login within the session TTL: no hashing needed
+    if (m_sys.sessions().check(u->id(), pass)) {
+        finishLogin(u);
+        return;
+    }
+
+    // Full password hash runs on a worker thread so the UI stays responsive.
+    // Only a copy of the stored record goes to the worker.
+    int userId = u->id();
+    PasswordRecord rec = u->passwordRecord();
+
+    loginBtn->setEnabled(false);
+    loginStatus->setText("Signing in...");
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, userId, pass]() {
+        bool ok = watcher->result();
+        watcher->deleteLater();
+        loginBtn->setEnabled(true);
+        loginStatus->setText("");
+
+        User* u = m_sys.findUserById(userId);
+        if (!ok || !u) {
+            loginStatus->setText("Invalid email or password.");
+            return;
+        }
+
+        m_sys.sessions().remember(userId, pass);
+        finishLogin(u);
+    });
+    watcher->setFuture(QtConcurrent::run(&PasswordHasher::verify, rec, pass));
+}
+
+void MainWindow::finishLogin(User* u)
+{
     m_current = u;
+    updateUploadProgress();
 
     QMessageBox::information(
         this, "Welcome",
@@ -385,9 +773,45 @@ void MainWindow::doLogin()
     gotoRoleHome();
 }
 
+MainWindow::~MainWindow()
+{
+    // background work on m_sys: finished before m_sys goes
+    m_sys.blobs().stopMaintenance();
+    m_blobMaintenance.waitForFinished();
+    delete m_ingestor;
+    QThreadPool::globalInstance()->waitForDone(); // search indexing, similarity scans, imports
+}
+
+void MainWindow::closeEvent(QCloseEvent* e)
+{
+    // fold the journal into a fresh snapshot so the next start replays nothing
+    if (!m_sys.checkpoint())
+        QMessageBox::warning(this, "Save", "Could not save data to " + m_sys.snapshotPath());
+    QMainWindow::closeEvent(e);
+}
+
 void MainWindow::doLogout()
 {
+    // what was shown during this session counts as read next time; pages the
+    // user never scrolled to stay unread
+    if (m_current) {
+        int begin, end;
+        m_notifModel->loadedRange(begin, end);
+        m_sys.markRangeRead(m_current, begin, end);
+    }
+
     m_current = nullptr;
+    refreshNotifications();
+    uploadStatus->clear();
+    updateUploadProgress(); // uploads keep going, the bar is per student
+    refreshStudentWork();
+    adminSearchEdit->clear();
+    facultySearchEdit->clear();
+    studentSearchEdit->clear();
+    courseSelectAdmin->setCurrentId(-1);
+    facultySelectAdmin->setCurrentId(-1);
+    courseSelectFaculty->setCurrentId(-1);
+    courseSelectStudent->setCurrentId(-1);
     emailEdit->clear();
     passEdit->clear();
     loginStatus->setText("");
@@ -408,12 +832,11 @@ void MainWindow::adminCreateCourse()
 
     Course* c = m_sys.adminCreateCourse(a, name);
     if (!c) {
-        QMessageBox::warning(this, "Error", "Could not create course (limit reached?).");
+        QMessageBox::warning(this, "Error", "Could not create course.");
         return;
     }
 
     courseNameEdit->clear();
-    refreshAllCombos();
     QMessageBox::information(this, "Done", "Created course: " + c->name());
 }
 
@@ -422,13 +845,10 @@ void MainWindow::adminAssignFaculty()
     Admin* a = m_sys.asAdmin(m_current);
     if (!a) return;
 
-    int courseId = courseSelectAdmin->currentData().toInt();
-
-    // Demo: get faculty user from seeded data
-    User* fuser = m_sys.login("faculty@lms.com", "1234");
-    Faculty* f = m_sys.asFaculty(fuser);
-    if (!f) {
-        QMessageBox::warning(this, "Error", "Faculty not found.");
+    int courseId = courseSelectAdmin->currentId();
+    Faculty* f = m_sys.asFaculty(m_sys.findUserById(facultySelectAdmin->currentId()));
+    if (courseId < 0 || !f) {
+        QMessageBox::warning(this, "Error", "Pick a course and a faculty member from the suggestions.");
         return;
     }
 
@@ -438,7 +858,6 @@ void MainWindow::adminAssignFaculty()
         return;
     }
 
-    refreshAllCombos();
     QMessageBox::information(this, "Done", "Faculty assigned.");
 }
 
@@ -448,7 +867,7 @@ void MainWindow::facultyPostAssignment()
     Faculty* f = m_sys.asFaculty(m_current);
     if (!f) return;
 
-    int courseId = courseSelectFaculty->currentData().toInt();
+    int courseId = courseSelectFaculty->currentId();
     QString title = assTitleEdit->text().trimmed();
     QString desc = assDescEdit->text().trimmed();
     QString due = assDueEdit->text().trimmed();
@@ -457,6 +876,10 @@ void MainWindow::facultyPostAssignment()
         QMessageBox::warning(this, "Error", "Title and due date required.");
         return;
     }
+    if (Assignment::parseDueDate(due) == 0) {
+        QMessageBox::warning(this, "Error", "Due date must be YYYY-MM-DD or YYYY-MM-DD hh:mm.");
+        return;
+    }
 
     Assignment* a = m_sys.facultyCreateAssignment(f, courseId, title, desc, due);
     if (!a) {
@@ -467,7 +890,6 @@ void MainWindow::facultyPostAssignment()
     assTitleEdit->clear();
     assDescEdit->clear();
     assDueEdit->clear();
-    refreshAllCombos();
 
     QMessageBox::information(this, "Done", "Assignment posted.");
 }
@@ -477,7 +899,12 @@ void MainWindow::facultyGrade()
     Faculty* f = m_sys.asFaculty(m_current);
     if (!f) return;
 
-    int subId = submissionSelect->currentData().toInt();
+    QModelIndex idx = submissionView->currentIndex();
+    if (!idx.isValid()) {
+        QMessageBox::warning(this, "Error", "Select a submission.");
+        return;
+    }
+    int subId = idx.data(Qt::UserRole).toInt();
     float grade = (float)gradeSpin->value();
 
     bool ok = m_sys.facultyGradeSubmission(f, subId, grade);
@@ -486,25 +913,128 @@ void MainWindow::facultyGrade()
         return;
     }
 
-    refreshAllCombos();
     QMessageBox::information(this, "Done", "Submission graded.");
 }
 
+void MainWindow::facultySaveSubmission()
+{
+    QModelIndex idx = submissionView->currentIndex();
+    if (!idx.isValid()) {
+        QMessageBox::warning(this, "Error", "Select a submission.");
+        return;
+    }
+    Submission* sub = m_sys.findSubmissionById(idx.data(Qt::UserRole).toInt());
+    if (!sub) return;
+
+    QIODevice* blob = m_sys.blobs().read(sub->contentHash());
+    if (!blob) {
+        QMessageBox::warning(this, "Error", "No stored file for this submission (submitted as " + sub->filePath() + ").");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Save submission", QFileInfo(sub->filePath()).fileName());
+    if (!path.isEmpty()) {
+        QFile out(path);
+        bool ok = out.open(QIODevice::WriteOnly);
+        QByteArray block;
+        while (ok && !(block = blob->read(INGEST_CHUNK_BYTES)).isEmpty())
+            ok = out.write(block) == block.size();
+        if (!ok) QMessageBox::warning(this, "Error", "Could not write " + path);
+    }
+    delete blob;
+}
+
+void MainWindow::facultyCheckSimilarity()
+{
+    Faculty* f = m_sys.asFaculty(m_current);
+    Assignment* a = m_sys.findAssignmentById(similarityAssignSelect->currentData().toInt());
+    if (!f || !a) {
+        QMessageBox::warning(this, "Error", "Select an assignment.");
+        return;
+    }
+    if (!a->course() || a->course()->faculty() != f) {
+        QMessageBox::warning(this, "Error", "Not your course.");
+        return;
+    }
+
+    // reads every stored file of the assignment: on a worker
+    SimilarityScan* scan = new SimilarityScan(m_sys, a);
+    checkSimilarityBtn->setEnabled(false);
+    similarityView->setPlainText("Comparing submissions of " + a->title() + "...");
+
+    QFutureWatcher<void>* watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, scan]() {
+        watcher->deleteLater();
+        checkSimilarityBtn->setEnabled(true);
+
+        QString t = scan->report().summary() + "\n\n";
+        if (scan->pairCount() == 0) t += "No similar submissions.";
+        for (int i = 0; i < scan->pairCount(); i++) {
+            const SimilarPair& p = scan->pairAt(i);
+            Submission* x = m_sys.findSubmissionById(p.submissionA);
+            Submission* y = m_sys.findSubmissionById(p.submissionB);
+            t += QString("%1%  (contained %2%)  #%3 %4  <->  #%5 %6\n")
+                .arg(qRound(p.similarity * 100), 3).arg(qRound(p.containment * 100), 3)
+                .arg(p.submissionA).arg(x && x->student() ? x->student()->name() : QString("?"))
+                .arg(p.submissionB).arg(y && y->student() ? y->student()->name() : QString("?"));
+        }
+        if (scan->report().pairs > scan->pairCount())
+            t += QString("... and %1 more").arg(scan->report().pairs - scan->pairCount());
+        delete scan;
+        similarityView->setPlainText(t);
+    });
+    watcher->setFuture(QtConcurrent::run([scan]() { scan->run(); }));
+}
+
+void MainWindow::facultyImportGrades()
+{
+    Faculty* f = m_sys.asFaculty(m_current);
+    if (!f) return;
+
+    QString path = QFileDialog::getOpenFileName(this, "Import gradebook CSV", QString(), "CSV files (*.csv);;All files (*)");
+    if (path.isEmpty()) return;
+
+    // parse and look rows up on a worker; only the grade batch runs here
+    int facultyId = f->id();
+    GradebookImporter* importer = new GradebookImporter();
+
+    importGradesBtn->setEnabled(false);
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, importer, facultyId, path]() {
+        bool ok = watcher->result();
+        watcher->deleteLater();
+        importGradesBtn->setEnabled(true);
+
+        if (!ok) {
+            delete importer;
+            QMessageBox::warning(this, "Import", "Could not read " + path);
+            return;
+        }
+
+        ImportReport r = importer->commit(m_sys, m_sys.asFaculty(m_sys.findUserById(facultyId)));
+        delete importer;
+        QMessageBox::information(this, "Import", r.summary());
+    });
+    const LMSSystem* sys = &m_sys;
+    watcher->setFuture(QtConcurrent::run([importer, sys, path]() { return importer->parse(*sys, path); }));
+}
+
 // ------------------------------ Student actions ------------------------------
 void MainWindow::studentEnroll()
 {
     Student* s = m_sys.asStudent(m_current);
     if (!s) return;
 
-    int courseId = courseSelectStudent->currentData().toInt();
+    int courseId = courseSelectStudent->currentId();
     bool ok = m_sys.studentEnroll(s, courseId);
 
     if (!ok) {
-        QMessageBox::warning(this, "Error", "Enroll failed (already enrolled or course full).");
+        QMessageBox::warning(this, "Error", "Enroll failed (already enrolled?).");
         return;
     }
 
-    refreshAllCombos();
+    refreshStudentWork();
     QMessageBox::information(this, "Done", "Enrolled successfully.");
 }
 
@@ -521,14 +1051,135 @@ void MainWindow::studentSubmit()
         return;
     }
 
-    Submission* sub = m_sys.studentSubmit(s, assignmentId, fp);
-    if (!sub) {
+    // refuse before copying anything, not after
+    Assignment* a = m_sys.findAssignmentById(assignmentId);
+    if (!a || !s->isEnrolled(a->course()) || m_sys.findSubmission(s, a)) {
         QMessageBox::warning(this, "Error", "Submit failed (not enrolled or duplicate submission).");
         return;
     }
+    for (auto it = m_uploads.constBegin(); it != m_uploads.constEnd(); ++it) {
+        if (it->studentUserId == s->id() && it->assignmentId == assignmentId) {
+            QMessageBox::warning(this, "Error", "This assignment is already uploading.");
+            return;
+        }
+    }
+    if (!QFileInfo(fp).isFile()) {
+        QMessageBox::warning(this, "Error", "No such file: " + fp);
+        return;
+    }
 
+    // copied and hashed in the background; recorded in onUploadFinished()
+    int ticket = m_ingestor->ingest(fp);
+    m_uploads.insert(ticket, PendingUpload{ s->id(), assignmentId, fp, 0, QFileInfo(fp).size() });
     filePathEdit->clear();
-    refreshAllCombos();
+    updateUploadProgress();
+}
+
+void MainWindow::studentBrowseFile()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Choose the file to submit");
+    if (!path.isEmpty()) filePathEdit->setText(path);
+}
 
-    QMessageBox::information(this, "Done", "Submitted successfully.");
+void MainWindow::onUploadProgress(int ticket, qint64 done, qint64 total)
+{
+    auto it = m_uploads.find(ticket);
+    if (it == m_uploads.end()) return;
+    it->done = done;
+    it->total = total;
+    updateUploadProgress();
+}
+
+void MainWindow::onUploadFinished(int ticket, const IngestedFile& file)
+{
+    PendingUpload up = m_uploads.take(ticket);
+    updateUploadProgress();
+
+    // the upload belongs to whoever started it, even if they logged out since
+    Student* s = m_sys.asStudent(m_sys.findUserById(up.studentUserId));
+    Submission* sub = m_sys.studentSubmit(s, up.assignmentId, up.source, file.sha256, file.size);
+    QString name = QFileInfo(up.source).fileName();
+    if (!sub) {
+        if (s == m_current)
+            QMessageBox::warning(this, "Error", "Submit failed for " + name + " (not enrolled or duplicate submission).");
+        return;
+    }
+    if (s != m_current) return;
+    refreshStudentWork();
+    uploadStatus->setText(QString("Submitted %1 (%2 KB, sha256 %3...%4)")
+        .arg(name).arg((file.size + 1023) / 1024).arg(QString::fromLatin1(file.sha256.toHex().left(12)))
+        .arg(file.deduplicated ? ", identical file already stored" : ""));
+}
+
+void MainWindow::onUploadFailed(int ticket, const QString& error)
+{
+    PendingUpload up = m_uploads.take(ticket);
+    updateUploadProgress();
+    if (m_current && up.studentUserId == m_current->id())
+        QMessageBox::warning(this, "Upload failed", QFileInfo(up.source).fileName() + ": " + error);
+}
+
+void MainWindow::updateUploadProgress()
+{
+    // the logged-in student's uploads, as one bar
+    int files = 0;
+    qint64 done = 0, total = 0;
+    for (auto it = m_uploads.constBegin(); it != m_uploads.constEnd(); ++it) {
+        if (!m_current || it->studentUserId != m_current->id()) continue;
+        files++;
+        done += it->done;
+        total += it->total;
+    }
+    if (files == 0) {
+        uploadProgress->hide();
+        return;
+    }
+    uploadProgress->setValue(total > 0 ? int(done * 1000 / total) : 0);
+    uploadProgress->show();
+    uploadStatus->setText(QString("Uploading %1 file(s): %2 of %3 MB")
+        .arg(files).arg(done / (1024.0 * 1024.0), 0, 'f', 1).arg(total / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
+void MainWindow::adminImportCsv()
+{
+    Admin* a = m_sys.asAdmin(m_current);
+    if (!a) return;
+
+    QString path = QFileDialog::getOpenFileName(this, "Import registrar CSV", QString(), "CSV files (*.csv);;All files (*)");
+    if (path.isEmpty()) return;
+
+    // parse, validate and hash passwords on worker threads; commit here in one batch
+    int adminId = a->id();
+    CsvImporter* importer = new CsvImporter();
+
+    importCsvBtn->setEnabled(false);
+    importStatus->setText("Importing...");
+
+    QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, importer, adminId, path]() {
+        bool ok = watcher->result();
+        watcher->deleteLater();
+        importCsvBtn->setEnabled(true);
+
+        if (!ok) {
+            delete importer;
+            importStatus->setText("");
+            QMessageBox::warning(this, "Import", "Could not read " + path);
+            return;
+        }
+
+        ImportReport r = importer->commit(m_sys, m_sys.asAdmin(m_sys.findUserById(adminId)));
+        delete importer;
+
+        importStatus->setText(QString("%1 rows, %2 rows/s").arg(r.rows).arg(qRound(r.rowsPerSecond())));
+        QMessageBox::information(this, "Import", r.summary());
+    });
+    watcher->setFuture(QtConcurrent::run([importer, path]() { return importer->parse(path); }));
+}
+
+void MainWindow::onBulkImported()
+{
+    // many rows changed at once: one reload instead of a delta per row
+    refreshAllCombos(); // includes refreshNotifications()
+    refreshCourseStats();
 }
@@ -4,16 +4,25 @@
 #include <QStackedWidget>
 #include <QLineEdit>
 #include <QLabel>
-#include <QListWidget>
 #include <QPushButton>
 #include <QComboBox>
 #include <QSpinBox>
+#include <QGroupBox>
+#include <QListView>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QProgressBar>
+#include <QCloseEvent>
+#include <QFuture>
 #include "lms_system.h"
+#include "list_models.h"
+#include "entity_picker.h"
+#include "submission_ingest.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
-        LMSSystem m_sys;
+        LMSSystem& m_sys;
     User* m_current;
 
     QStackedWidget* stack;
@@ -22,45 +31,90 @@ class MainWindow : public QMainWindow {
     QWidget* loginPage;
     QLineEdit* emailEdit;
     QLineEdit* passEdit;
+    QPushButton* loginBtn;
     QLabel* loginStatus;
 
     // Admin UI
     QWidget* adminPage;
     QLineEdit* courseNameEdit;
     QPushButton* createCourseBtn;
-    QComboBox* courseSelectAdmin;
-    QComboBox* facultySelectAdmin;
+    EntityPicker* courseSelectAdmin;
+    EntityPicker* facultySelectAdmin;
     QPushButton* assignFacultyBtn;
-    QListWidget* adminNotifs;
+    QPushButton* importCsvBtn;
+    QLabel* importStatus;
+    QListView* adminNotifs;
+    QGroupBox* adminNotifsBox;
 
     // Faculty UI
     QWidget* facultyPage;
-    QComboBox* courseSelectFaculty;
+    EntityPicker* courseSelectFaculty; // own courses only
     QLineEdit* assTitleEdit;
     QLineEdit* assDueEdit;
     QLineEdit* assDescEdit;
     QPushButton* postAssBtn;
-    QComboBox* submissionSelect;
+    QListView* submissionView;
     QSpinBox* gradeSpin;
     QPushButton* gradeBtn;
-    QListWidget* facultyNotifs;
+    QPushButton* saveSubmissionBtn;
+    QPushButton* importGradesBtn;
+    QPlainTextEdit* courseStatsView;
+    QComboBox* similarityAssignSelect;
+    QPushButton* checkSimilarityBtn;
+    QPlainTextEdit* similarityView;
+    QListView* facultyNotifs;
+    QGroupBox* facultyNotifsBox;
 
     // Student UI
     QWidget* studentPage;
-    QComboBox* courseSelectStudent;
+    EntityPicker* courseSelectStudent;
     QPushButton* enrollBtn;
-    QComboBox* assignmentSelectStudent;
+    QComboBox* assignmentSelectStudent; // open work of the enrolled courses only
     QLineEdit* filePathEdit;
+    QPushButton* browseFileBtn;
     QPushButton* submitBtn;
-    QListWidget* studentNotifs;
+    QProgressBar* uploadProgress;
+    QLabel* uploadStatus;
+    QListWidget* studentWorkView; // own submissions and grades
+    QListView* studentNotifs;
+    QGroupBox* studentNotifsBox;
+
+    // Search box on each dashboard
+    QLineEdit* adminSearchEdit;
+    QListWidget* adminSearchResults;
+    QLineEdit* facultySearchEdit;
+    QListWidget* facultySearchResults;
+    QLineEdit* studentSearchEdit;
+    QListWidget* studentSearchResults;
 
     // Logout buttons
     QPushButton* logoutBtn1;
     QPushButton* logoutBtn2;
     QPushButton* logoutBtn3;
 
+    // Lazy models behind the list views (shared by the three dashboards)
+    NotificationListModel* m_notifModel;
+    SubmissionListModel* m_submissionModel;
+
+    // Submission files being copied into the store; the submission is
+    // recorded once its copy is complete
+    struct PendingUpload {
+        int studentUserId;
+        int assignmentId;
+        QString source;
+        qint64 done;
+        qint64 total;
+    };
+    SubmissionIngestor* m_ingestor;
+    QFuture<BlobStore::Maintenance> m_blobMaintenance;
+    QHash<int, PendingUpload> m_uploads; // by ticket
+
 public:
-    explicit MainWindow(QWidget* parent = nullptr);
+    explicit MainWindow(LMSSystem& sys, QWidget* parent = nullptr); // sys: store already open
+    ~MainWindow();
+
+protected:
+    void closeEvent(QCloseEvent* e) override;
 
 private:
     QWidget* buildLoginPage();
@@ -70,21 +124,47 @@ private:
 
     void refreshAllCombos();
     void refreshNotifications();
+    void updateUnreadTitle();
+    void refreshCourseStats();
+    void refreshSimilarityAssignments();
+    void refreshStudentWork();
+    void updateUploadProgress();
+    QGroupBox* notifBoxFor(Role r) const;
+    QGroupBox* buildSearchBox(QLineEdit*& edit, QListWidget*& results);
+    void runSearch(QLineEdit* edit, QListWidget* results);
+    void openSearchHit(QListWidgetItem* item);
     void gotoRoleHome();
+    void finishLogin(User* u);
 
 private slots:
+    // LMSSystem change events: apply just the delta
+    void onAssignmentPosted(Assignment* a);
+    void onSubmissionAdded(Submission* sub);
+    void onSubmissionGraded(Submission* sub);
+    void onSubmissionsGraded(Faculty* f, int count);
+    void onNotificationsDelivered();
+    void onBulkImported();
+
     void doLogin();
     void doLogout();
 
     // Admin actions
     void adminCreateCourse();
     void adminAssignFaculty();
+    void adminImportCsv();
 
     // Faculty actions
     void facultyPostAssignment();
     void facultyGrade();
+    void facultySaveSubmission();
+    void facultyCheckSimilarity();
+    void facultyImportGrades();
 
     // Student actions
     void studentEnroll();
     void studentSubmit();
+    void studentBrowseFile();
+    void onUploadProgress(int ticket, qint64 done, qint64 total);
+    void onUploadFinished(int ticket, const IngestedFile& file);
+    void onUploadFailed(int ticket, const QString& error);
 };
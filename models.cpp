@@ -2,70 +2,90 @@
 #include "models.h"
 
 // ----------------- User -----------------
-User::User(int id, const QString& name, const QString& email, const QString& pass, Role role)
+User::User(int id, QStringView name, QStringView email, const PasswordRecord& pass, Role role)
     : m_userId(id), m_name(name), m_email(email), m_password(pass), m_role(role) {
 }
 
 int User::id() const { return m_userId; }
-QString User::name() const { return m_name; }
-QString User::email() const { return m_email; }
+QString User::name() const { return pooledString(m_name); }
+QString User::email() const { return pooledString(m_email); }
+QStringView User::nameView() const { return m_name; }
+QStringView User::emailView() const { return m_email; }
 Role User::role() const { return m_role; }
-bool User::checkPassword(const QString& pass) const { return m_password == pass; }
+Inbox& User::inbox() { return m_inbox; }
+const Inbox& User::inbox() const { return m_inbox; }
+const PasswordRecord& User::passwordRecord() const { return m_password; }
+bool User::checkPassword(const QString& pass) const { return PasswordHasher::verify(m_password, pass); }
 
 // ----------------- Student -----------------
-Student::Student(int uid, int sid, const QString& name, const QString& email, const QString& pass)
-    : User(uid, name, email, pass, Role::Student), m_studentId(sid), m_enrolledCount(0) {
-    for (int i = 0; i < MAX_STUDENT_COURSES; i++) m_enrolled[i] = nullptr;
+Student::Student(int uid, int sid, QStringView name, QStringView email, const PasswordRecord& pass)
+    : User(uid, name, email, pass, Role::Student), m_studentId(sid) {
 }
 
 int Student::studentId() const { return m_studentId; }
-int Student::enrolledCount() const { return m_enrolledCount; }
+int Student::enrolledCount() const { return m_enrolled.count(); }
 
 Course* Student::enrolledAt(int i) const {
-    if (i < 0 || i >= m_enrolledCount) return nullptr;
+    if (i < 0 || i >= m_enrolled.count()) return nullptr;
     return m_enrolled[i];
 }
 
 bool Student::isEnrolled(Course* c) const {
     if (!c) return false;
-    for (int i = 0; i < m_enrolledCount; i++)
-        if (m_enrolled[i] == c) return true;
-    return false;
+    return m_enrolled.contains(c);
 }
 
 bool Student::enroll(Course* c) {
     if (!c) return false;
     if (isEnrolled(c)) return false;
-    if (m_enrolledCount >= MAX_STUDENT_COURSES) return false;
-    m_enrolled[m_enrolledCount++] = c;
+    m_enrolled.append(c);
     return true;
 }
 
+int Student::submissionCount() const { return m_submissions.count(); }
+
+Submission* Student::submissionAt(int i) const {
+    if (i < 0 || i >= m_submissions.count()) return nullptr;
+    return m_submissions[i];
+}
+
+void Student::addSubmission(Submission* sub) {
+    if (sub) m_submissions.append(sub);
+}
+
 // ----------------- Faculty -----------------
-Faculty::Faculty(int uid, int fid, const QString& name, const QString& email, const QString& pass)
-    : User(uid, name, email, pass, Role::Faculty), m_facultyId(fid), m_assignedCount(0) {
-    for (int i = 0; i < MAX_FACULTY_COURSES; i++) m_assigned[i] = nullptr;
+Faculty::Faculty(int uid, int fid, QStringView name, QStringView email, const PasswordRecord& pass)
+    : User(uid, name, email, pass, Role::Faculty), m_facultyId(fid) {
 }
 
 int Faculty::facultyId() const { return m_facultyId; }
-int Faculty::assignedCount() const { return m_assignedCount; }
+int Faculty::assignedCount() const { return m_assigned.count(); }
 
 Course* Faculty::assignedAt(int i) const {
-    if (i < 0 || i >= m_assignedCount) return nullptr;
+    if (i < 0 || i >= m_assigned.count()) return nullptr;
     return m_assigned[i];
 }
 
 bool Faculty::assignCourse(Course* c) {
     if (!c) return false;
-    for (int i = 0; i < m_assignedCount; i++)
-        if (m_assigned[i] == c) return false;
-    if (m_assignedCount >= MAX_FACULTY_COURSES) return false;
-    m_assigned[m_assignedCount++] = c;
+    if (m_assigned.contains(c)) return false;
+    m_assigned.append(c);
     return true;
 }
 
+int Faculty::submissionCount() const { return m_submissions.count(); }
+
+Submission* Faculty::submissionAt(int i) const {
+    if (i < 0 || i >= m_submissions.count()) return nullptr;
+    return m_submissions[i];
+}
+
+void Faculty::addSubmission(Submission* sub) {
+    if (sub) m_submissions.append(sub);
+}
+
 // ----------------- Admin -----------------
-Admin::Admin(int uid, int aid, const QString& name, const QString& email, const QString& pass)
+Admin::Admin(int uid, int aid, QStringView name, QStringView email, const PasswordRecord& pass)
     : User(uid, name, email, pass, Role::Admin), m_adminId(aid) {
 }
 
@@ -73,30 +93,129 @@ int Admin::adminId() const { return m_adminId; }
 
 // ----------------- Notification -----------------
 Notification::Notification()
-    : m_id(-1), m_sender(nullptr), m_receiver(nullptr), m_isRead(false) {
+    : m_id(-1), m_pool(nullptr), m_template(0), m_argCount(0), m_sender(nullptr), m_recipientCount(0) {
+    for (int i = 0; i < NOTIF_MAX_ARGS; i++) m_args[i] = 0;
 }
 
-void Notification::set(int id, const QString& msg, User* sender, User* receiver, const QDateTime& t) {
+void Notification::set(int id, const StringPool* pool, Symbol tmpl, const Symbol* args, int argCount,
+    User* sender, const QDateTime& t) {
     m_id = id;
-    m_message = msg;
+    m_pool = pool;
+    m_template = tmpl;
+    m_argCount = qMin(argCount, NOTIF_MAX_ARGS);
+    for (int i = 0; i < NOTIF_MAX_ARGS; i++) m_args[i] = (args && i < m_argCount) ? args[i] : 0;
     m_sender = sender;
-    m_receiver = receiver;
     m_time = t;
-    m_isRead = false;
+    m_recipientCount = 0;
 }
 
 int Notification::id() const { return m_id; }
-QString Notification::message() const { return m_message; }
+
+QString Notification::message() const {
+    if (!m_pool) return QString();
+    QStringView tmpl = m_pool->view(m_template);
+    if (m_argCount == 0) return tmpl.toString();
+
+    // expand %1..%N in one pass
+    QString out;
+    out.reserve(tmpl.size() + 32 * m_argCount);
+    for (qsizetype i = 0; i < tmpl.size(); i++) {
+        QChar ch = tmpl[i];
+        if (ch == QChar('%') && i + 1 < tmpl.size()) {
+            int n = tmpl[i + 1].unicode() - '1';
+            if (n >= 0 && n < m_argCount) {
+                out += m_pool->view(m_args[n]);
+                i++;
+                continue;
+            }
+        }
+        out += ch;
+    }
+    return out;
+}
+
+Symbol Notification::templateSymbol() const { return m_template; }
+int Notification::argCount() const { return m_argCount; }
+Symbol Notification::argSymbol(int i) const { return (i >= 0 && i < m_argCount) ? m_args[i] : 0; }
 User* Notification::sender() const { return m_sender; }
-User* Notification::receiver() const { return m_receiver; }
 QDateTime Notification::time() const { return m_time; }
-bool Notification::isRead() const { return m_isRead; }
-void Notification::markRead() { m_isRead = true; }
+int Notification::recipientCount() const { return m_recipientCount; }
+void Notification::addRecipients(int n) { m_recipientCount += n; }
+
+// ----------------- Inbox -----------------
+Inbox::Inbox()
+    : m_unread(0), m_firstUnread(0), m_packed(nullptr), m_packedCount(0), m_packedSource(nullptr) {
+}
+
+void Inbox::decode() const {
+    if (!m_packed) return;
+
+    m_items.reserve(m_items.count() + m_packedCount);
+    for (int i = 0; i < m_packedCount; i++) {
+        quint32 v = m_packed[i];
+        m_items.append(Entry{ m_packedSource->at(int(v >> 1)), (v & 1u) != 0 });
+    }
+    m_packed = nullptr;
+    m_packedCount = 0;
+
+    while (m_firstUnread < m_items.count() && m_items[m_firstUnread].read) m_firstUnread++;
+}
+
+void Inbox::append(Notification* n) {
+    if (!n) return;
+    decode();
+    m_items.append(Entry{ n, false });
+    m_unread++;
+}
+
+bool Inbox::isPacked() const { return m_packed != nullptr; }
+void Inbox::unpack() const { decode(); }
+
+int Inbox::count() const { return m_packed ? m_packedCount : m_items.count(); }
+
+Notification* Inbox::at(int i) const {
+    decode();
+    if (i < 0 || i >= m_items.count()) return nullptr;
+    return m_items[i].notif;
+}
+
+bool Inbox::isRead(int i) const {
+    decode();
+    if (i < 0 || i >= m_items.count()) return true;
+    return m_items[i].read;
+}
+
+int Inbox::unreadCount() const { return m_unread; }
+
+void Inbox::markRead(int i) {
+    decode();
+    if (i < 0 || i >= m_items.count() || m_items[i].read) return;
+    m_items[i].read = true;
+    m_unread--;
+}
+
+void Inbox::markAllRead(int end) {
+    decode();
+    if (end < 0 || end > m_items.count()) end = m_items.count();
+    markRangeRead(0, end);
+}
+
+void Inbox::markRangeRead(int begin, int end) {
+    decode();
+    end = qMin(end, m_items.count());
+    // only the tail since the last markAllRead can still be unread
+    for (int i = qMax(begin, m_firstUnread); i < end; i++) markRead(i);
+    if (begin <= m_firstUnread) m_firstUnread = qMax(m_firstUnread, end);
+}
 
 // ----------------- Submission -----------------
 Submission::Submission()
-    : m_id(-1), m_student(nullptr), m_assignment(nullptr),
-    m_grade(0.0f), m_status(SubmissionStatus::Pending) {
+    : m_id(-1), m_student(nullptr), m_assignment(nullptr), m_size(0),
+    m_grade(0.0f), m_status(SubmissionStatus::Pending), m_gradeRow(-1) {
+}
+
+Submission::Submission(int id, Student* s, Assignment* a, const QString& filePath) : Submission() {
+    set(id, s, a, filePath);
 }
 
 void Submission::set(int id, Student* s, Assignment* a, const QString& filePath) {
@@ -120,91 +239,106 @@ void Submission::setGrade(float g) {
     m_status = SubmissionStatus::Graded;
 }
 
+void Submission::setContent(const QByteArray& sha256, qint64 size) {
+    m_sha256 = sha256;
+    m_size = size;
+}
+
+QByteArray Submission::contentHash() const { return m_sha256; }
+qint64 Submission::contentSize() const { return m_size; }
+
+int Submission::gradeRow() const { return m_gradeRow; }
+void Submission::setGradeRow(int row) { m_gradeRow = row; }
+
 // ----------------- Assignment -----------------
-Assignment::Assignment() : m_id(-1), m_course(nullptr), m_subCount(0) {
-    for (int i = 0; i < MAX_ASSIGN_SUBMISSIONS; i++) m_submissions[i] = nullptr;
+Assignment::Assignment() : m_id(-1), m_dueMs(0), m_course(nullptr), m_gradeColumn(-1) {
 }
 
-void Assignment::set(int id, const QString& title, const QString& desc, const QString& due, Course* c) {
+Assignment::Assignment(int id, QStringView title, QStringView desc, qint64 dueMs, Course* c) : Assignment() {
+    set(id, title, desc, dueMs, c);
+}
+
+void Assignment::set(int id, QStringView title, QStringView desc, qint64 dueMs, Course* c) {
     m_id = id;
     m_title = title;
     m_description = desc;
-    m_dueDate = due;
+    m_dueMs = dueMs;
     m_course = c;
 }
 
 int Assignment::id() const { return m_id; }
-QString Assignment::title() const { return m_title; }
-QString Assignment::description() const { return m_description; }
-QString Assignment::dueDate() const { return m_dueDate; }
+QString Assignment::title() const { return pooledString(m_title); }
+QString Assignment::description() const { return pooledString(m_description); }
+QStringView Assignment::titleView() const { return m_title; }
+QStringView Assignment::descriptionView() const { return m_description; }
 Course* Assignment::course() const { return m_course; }
+qint64 Assignment::dueMs() const { return m_dueMs; }
 
-int Assignment::submissionCount() const { return m_subCount; }
+QString Assignment::dueDate() const {
+    return m_dueMs > 0 ? QDateTime::fromMSecsSinceEpoch(m_dueMs).toString("yyyy-MM-dd hh:mm") : QString();
+}
+
+qint64 Assignment::parseDueDate(const QString& text) {
+    QString t = text.trimmed();
+    QDate day = QDate::fromString(t, "yyyy-MM-dd");
+    QDateTime at = day.isValid() ? QDateTime(day, QTime(23, 59)) : QDateTime::fromString(t, "yyyy-MM-dd hh:mm");
+    if (!at.isValid()) at = QDateTime::fromString(t, Qt::ISODate);
+    return at.isValid() ? qMax<qint64>(1, at.toMSecsSinceEpoch()) : 0;
+}
+
+int Assignment::submissionCount() const { return m_submissions.count(); }
 
 Submission* Assignment::submissionAt(int i) const {
-    if (i < 0 || i >= m_subCount) return nullptr;
+    if (i < 0 || i >= m_submissions.count()) return nullptr;
     return m_submissions[i];
 }
 
 bool Assignment::addSubmission(Submission* sub) {
     if (!sub) return false;
-
-    // no duplicate submissions by same student
-    for (int i = 0; i < m_subCount; i++) {
-        if (m_submissions[i] && m_submissions[i]->student() == sub->student())
-            return false;
-    }
-
-    if (m_subCount >= MAX_ASSIGN_SUBMISSIONS) return false;
-    m_submissions[m_subCount++] = sub;
+    m_submissions.append(sub);
     return true;
 }
 
+int Assignment::gradeColumn() const { return m_gradeColumn; }
+void Assignment::setGradeColumn(int column) { m_gradeColumn = column; }
+
 // ----------------- Course -----------------
-Course::Course() : m_id(-1), m_faculty(nullptr), m_studentCount(0), m_assignCount(0) {
-    for (int i = 0; i < MAX_COURSE_STUDENTS; i++) m_students[i] = nullptr;
-    for (int i = 0; i < MAX_COURSE_ASSIGNMENTS; i++) m_assignments[i] = nullptr;
+Course::Course() : m_id(-1), m_faculty(nullptr) {
 }
 
-void Course::set(int id, const QString& name) { m_id = id; m_name = name; }
+Course::Course(int id, QStringView name) : Course() { set(id, name); }
+
+void Course::set(int id, QStringView name) { m_id = id; m_name = name; }
 int Course::id() const { return m_id; }
-QString Course::name() const { return m_name; }
+QString Course::name() const { return pooledString(m_name); }
+QStringView Course::nameView() const { return m_name; }
 
 void Course::setFaculty(Faculty* f) { m_faculty = f; }
 Faculty* Course::faculty() const { return m_faculty; }
 
-int Course::studentCount() const { return m_studentCount; }
+int Course::studentCount() const { return m_students.count(); }
 
 Student* Course::studentAt(int i) const {
-    if (i < 0 || i >= m_studentCount) return nullptr;
+    if (i < 0 || i >= m_students.count()) return nullptr;
     return m_students[i];
 }
 
-int Course::assignmentCount() const { return m_assignCount; }
+int Course::assignmentCount() const { return m_assignments.count(); }
 
 Assignment* Course::assignmentAt(int i) const {
-    if (i < 0 || i >= m_assignCount) return nullptr;
+    if (i < 0 || i >= m_assignments.count()) return nullptr;
     return m_assignments[i];
 }
 
-bool Course::hasStudent(Student* s) const {
-    if (!s) return false;
-    for (int i = 0; i < m_studentCount; i++)
-        if (m_students[i] == s) return true;
-    return false;
-}
-
+// callers check Student::isEnrolled() first: the roster can be long
 bool Course::addStudent(Student* s) {
     if (!s) return false;
-    if (hasStudent(s)) return false;
-    if (m_studentCount >= MAX_COURSE_STUDENTS) return false;
-    m_students[m_studentCount++] = s;
+    m_students.append(s);
     return true;
 }
 
 bool Course::addAssignment(Assignment* a) {
     if (!a) return false;
-    if (m_assignCount >= MAX_COURSE_ASSIGNMENTS) return false;
-    m_assignments[m_assignCount++] = a;
+    m_assignments.append(a);
     return true;
 }
@@ -3,41 +3,102 @@
 #include <QString>
 #include <QDateTime>
 #include "constants.h"
+#include "arena.h"
+#include "auth.h"
+#include "string_pool.h"
 
 enum class Role { Admin, Faculty, Student };
 enum class SubmissionStatus { Pending, Submitted, Graded };
 
 class Course;
 class Assignment;
+class Submission;
+class Notification;
+class SnapshotIO;
+
+// Per-user notification list.
+// O(1) append, O(k) read where k is this user's own messages; the unread count
+// is kept up to date on append/markRead so dashboards never recount.
+// Each entry is just a pointer to the shared Notification plus a read flag,
+// so a broadcast to N users stores its text once and N small entries.
+class Inbox {
+    struct Entry {
+        Notification* notif;
+        bool read;
+    };
+
+    mutable GrowArray<Entry> m_items;
+    int m_unread;
+    mutable int m_firstUnread; // every item before this index is read
+
+    // Entries loaded from a snapshot stay packed in the mapped file,
+    // ((notification index << 1) | read), until something reads them.
+    // count() and unreadCount() never need to decode.
+    mutable const quint32* m_packed;
+    mutable int m_packedCount;
+    mutable const SlabArena<Notification>* m_packedSource;
+
+    void decode() const;
+
+    friend class SnapshotIO;
 
+public:
+    Inbox();
+
+    void append(Notification* n);
+
+    // Still packed in the snapshot: the first read decodes it (a write).
+    // Threads sharing an inbox unpack() it under an exclusive lock first.
+    bool isPacked() const;
+    void unpack() const;
+
+    int count() const;
+    Notification* at(int i) const;
+    bool isRead(int i) const;
+    int unreadCount() const;
+
+    void markRead(int i);
+    void markAllRead(int end = -1); // items before end (default: all)
+    void markRangeRead(int begin, int end); // items in [begin, end)
+};
+
+// Text fields are views into the LMSSystem's StringPool: name() etc. wrap
+// the pooled text without copying, the *View() accessors avoid even that.
 class User {
 protected:
     int m_userId;
-    QString m_name;
-    QString m_email;
-    QString m_password; // demo only
+    QStringView m_name;
+    QStringView m_email;
+    PasswordRecord m_password; // salted hash, never the plaintext
     Role m_role;
+    Inbox m_inbox;
 
 public:
-    User(int id, const QString& name, const QString& email, const QString& pass, Role role);
+    User(int id, QStringView name, QStringView email, const PasswordRecord& pass, Role role);
     virtual ~User() = default;
 
     int id() const;
     QString name() const;
     QString email() const;
+    QStringView nameView() const;
+    QStringView emailView() const;
     Role role() const;
 
-    bool checkPassword(const QString& pass) const;
+    Inbox& inbox();
+    const Inbox& inbox() const;
+
+    const PasswordRecord& passwordRecord() const;
+    bool checkPassword(const QString& pass) const; // slow (full hash), keep off the GUI thread
 };
 
 class Student : public User {
     int m_studentId;
 
-    Course* m_enrolled[MAX_STUDENT_COURSES];
-    int m_enrolledCount;
+    GrowArray<Course*> m_enrolled;
+    GrowArray<Submission*> m_submissions; // own work, oldest first
 
 public:
-    Student(int uid, int sid, const QString& name, const QString& email, const QString& pass);
+    Student(int uid, int sid, QStringView name, QStringView email, const PasswordRecord& pass);
 
     int studentId() const;
     int enrolledCount() const;
@@ -45,64 +106,86 @@ public:
 
     bool enroll(Course* c);
     bool isEnrolled(Course* c) const;
+
+    int submissionCount() const;
+    Submission* submissionAt(int i) const;
+    void addSubmission(Submission* sub);
 };
 
 class Faculty : public User {
     int m_facultyId;
 
-    Course* m_assigned[MAX_FACULTY_COURSES];
-    int m_assignedCount;
+    GrowArray<Course*> m_assigned;
+    GrowArray<Submission*> m_submissions; // grading queue for this faculty's courses
 
 public:
-    Faculty(int uid, int fid, const QString& name, const QString& email, const QString& pass);
+    Faculty(int uid, int fid, QStringView name, QStringView email, const PasswordRecord& pass);
 
     int facultyId() const;
     int assignedCount() const;
     Course* assignedAt(int i) const;
 
     bool assignCourse(Course* c);
+
+    int submissionCount() const;
+    Submission* submissionAt(int i) const;
+    void addSubmission(Submission* sub);
 };
 
 class Admin : public User {
     int m_adminId;
 
 public:
-    Admin(int uid, int aid, const QString& name, const QString& email, const QString& pass);
+    Admin(int uid, int aid, QStringView name, QStringView email, const PasswordRecord& pass);
     int adminId() const;
 };
 
+// Message content, stored once per send/broadcast and shared by every
+// recipient's Inbox entry. Read state lives in the Inbox, not here.
+// The text is an interned template ("New assignment posted: %1 in %2") plus
+// interned arguments; message() fills it in only when someone reads it.
 class Notification {
     int m_id;
-    QString m_message;
+    const StringPool* m_pool;
+    Symbol m_template;
+    Symbol m_args[NOTIF_MAX_ARGS];
+    int m_argCount;
     User* m_sender;
-    User* m_receiver;
     QDateTime m_time;
-    bool m_isRead;
+    int m_recipientCount;
 
 public:
     Notification();
 
-    void set(int id, const QString& msg, User* sender, User* receiver, const QDateTime& t);
+    void set(int id, const StringPool* pool, Symbol tmpl, const Symbol* args, int argCount,
+        User* sender, const QDateTime& t);
     int id() const;
     QString message() const;
+    Symbol templateSymbol() const;
+    int argCount() const;
+    Symbol argSymbol(int i) const;
     User* sender() const;
-    User* receiver() const;
     QDateTime time() const;
-    bool isRead() const;
-    void markRead();
+
+    int recipientCount() const;
+    void addRecipients(int n);
 };
 
 class Submission {
     int m_id;
     Student* m_student;
     Assignment* m_assignment;
-    QString m_filePath;
+    QString m_filePath;   // as the student named it
+    QByteArray m_sha256;  // content: blob key in the BlobStore, empty if never stored
+    qint64 m_size;
 
     float m_grade;
     SubmissionStatus m_status;
+    int m_gradeRow; // row in the assignment's Gradebook column
 
 public:
     Submission();
+    Submission(int id, Student* s, Assignment* a, const QString& filePath);
 
     void set(int id, Student* s, Assignment* a, const QString& filePath);
     int id() const;
@@ -110,59 +193,81 @@ public:
     Assignment* assignment() const;
     QString filePath() const;
 
+    void setContent(const QByteArray& sha256, qint64 size);
+    QByteArray contentHash() const;
+    qint64 contentSize() const;
+
     float grade() const;
     SubmissionStatus status() const;
 
     void setGrade(float g);
+
+    int gradeRow() const;
+    void setGradeRow(int row);
 };
 
 class Assignment {
     int m_id;
-    QString m_title;
-    QString m_description;
-    QString m_dueDate;
+    QStringView m_title;
+    QStringView m_description;
+    qint64 m_dueMs; // ms since epoch, UTC; 0 = no due date
 
     Course* m_course;
+    int m_gradeColumn; // Gradebook column holding this assignment's grades
+
+    GrowArray<Submission*> m_submissions;
 
-    Submission* m_submissions[MAX_ASSIGN_SUBMISSIONS];
-    int m_subCount;
+    friend class SnapshotIO;
 
 public:
     Assignment();
+    Assignment(int id, QStringView title, QStringView desc, qint64 dueMs, Course* c);
 
-    void set(int id, const QString& title, const QString& desc, const QString& due, Course* c);
+    void set(int id, QStringView title, QStringView desc, qint64 dueMs, Course* c);
 
     int id() const;
     QString title() const;
     QString description() const;
-    QString dueDate() const;
+    qint64 dueMs() const;
+    QString dueDate() const; // local "yyyy-MM-dd hh:mm", empty if none
+    QStringView titleView() const;
+    QStringView descriptionView() const;
     Course* course() const;
 
     int submissionCount() const;
     Submission* submissionAt(int i) const;
 
+    // one per student: LMSSystem checks its (student, assignment) index first
     bool addSubmission(Submission* sub);
+
+    int gradeColumn() const;
+    void setGradeColumn(int column);
+
+    // "yyyy-MM-dd" (end of that day), "yyyy-MM-dd hh:mm" (local time) or ISO 8601
+    // with an offset; 0 if it is none of these
+    static qint64 parseDueDate(const QString& text);
 };
 
 class Course {
     int m_id;
-    QString m_name;
+    QStringView m_name;
 
     Faculty* m_faculty;
 
-    Student* m_students[MAX_COURSE_STUDENTS];
-    int m_studentCount;
+    GrowArray<Student*> m_students;
+    GrowArray<Assignment*> m_assignments;
 
-    Assignment* m_assignments[MAX_COURSE_ASSIGNMENTS];
-    int m_assignCount;
+    friend class SnapshotIO;
 
 public:
     Course();
+    Course(int id, QStringView name);
 
-    void set(int id, const QString& name);
+    void set(int id, QStringView name);
 
     int id() const;
     QString name() const;
+    QStringView nameView() const;
 
     void setFaculty(Faculty* f);
     Faculty* faculty() const;
@@ -173,8 +278,7 @@ public:
     int assignmentCount() const;
     Assignment* assignmentAt(int i) const;
 
-    bool addStudent(Student* s);
-    bool hasStudent(Student* s) const;
+    bool addStudent(Student* s); // no duplicate check
 
     bool addAssignment(Assignment* a);
 };
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+
+// Lock-free multi-producer / single-consumer FIFO (intrusive, Vyukov style).
+// T needs a `std::atomic<T*> next` member and a default constructor (one T is
+// kept inside as a stub node). push() is one atomic exchange plus one store and
+// never blocks or allocates; pop() belongs to a single consumer thread.
+// The queue does not own the nodes: whoever pops one frees it.
+template<typename T>
+class MpscQueue {
+    std::atomic<T*> m_head; // last pushed (producers)
+    T* m_tail;              // next to pop (consumer)
+    T m_stub;
+
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub) { m_stub.next.store(nullptr, std::memory_order_relaxed); }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any thread
+    void push(T* n) {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        T* prev = m_head.exchange(n); // seq_cst: see isEmpty()
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // consumer only. nullptr when empty, or when the newest node is still
+    // being linked in by its producer (try again shortly).
+    T* pop() {
+        T* tail = m_tail;
+        T* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_stub) {
+            if (!next) return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != m_head.load(std::memory_order_acquire)) return nullptr; // push in progress
+        push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    // consumer only. False as soon as any push has started, so a consumer that
+    // publishes "going to sleep" and then sees true cannot miss a producer that
+    // checks that flag after pushing (both sides seq_cst).
+    bool isEmpty() const { return m_head.load() == m_tail; }
+};
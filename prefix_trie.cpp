@@ -0,0 +1,82 @@
+#include "prefix_trie.h"
+
+PrefixTrie::PrefixTrie() {
+    m_nodes.append(Node{ 0, -1, -1, -1 });
+}
+
+int PrefixTrie::nodeCount() const { return m_nodes.count(); }
+
+QString PrefixTrie::normalize(const QString& text) {
+    return text.simplified().toLower();
+}
+
+void PrefixTrie::insert(QStringView key, int payload) {
+    int node = 0;
+    for (QChar qc : key) {
+        char16_t ch = qc.unicode();
+        // find the child or link a new one in sorted position
+        int prev = -1;
+        int child = m_nodes[node].firstChild;
+        while (child >= 0 && m_nodes[child].ch < ch) {
+            prev = child;
+            child = m_nodes[child].nextSibling;
+        }
+        if (child < 0 || m_nodes[child].ch != ch) {
+            int fresh = m_nodes.count();
+            m_nodes.append(Node{ ch, -1, child, -1 });
+            if (prev < 0) m_nodes[node].firstChild = fresh;
+            else m_nodes[prev].nextSibling = fresh;
+            child = fresh;
+        }
+        node = child;
+    }
+
+    // a payload's words are inserted together, so a repeat can only be the head
+    // (complete() dedupes whatever gets through)
+    int firstValue = m_nodes[node].firstValue;
+    if (firstValue >= 0 && m_values[firstValue].payload == payload) return;
+    m_values.append(Value{ payload, firstValue });
+    m_nodes[node].firstValue = m_values.count() - 1;
+}
+
+void PrefixTrie::insertWords(const QString& text, int payload) {
+    QString key = normalize(text);
+    for (int i = 0; i < key.size(); i++) {
+        if (i == 0 || (!key[i - 1].isLetterOrNumber() && key[i].isLetterOrNumber()))
+            insert(QStringView(key).mid(i), payload);
+    }
+}
+
+int PrefixTrie::complete(QStringView prefix, int* out, int max, const std::function<bool(int)>& accept) const {
+    int node = 0;
+    for (QChar qc : prefix) {
+        char16_t ch = qc.unicode();
+        int child = m_nodes[node].firstChild;
+        while (child >= 0 && m_nodes[child].ch < ch) child = m_nodes[child].nextSibling;
+        if (child < 0 || m_nodes[child].ch != ch) return 0;
+        node = child;
+    }
+
+    // breadth first: shorter keys (closer matches) come before longer ones
+    int n = 0;
+    GrowArray<int> level;
+    GrowArray<int> next;
+    level.append(node);
+    while (!level.isEmpty() && n < max) {
+        next.clear();
+        for (int i = 0; i < level.count() && n < max; i++) {
+            const Node& nd = m_nodes[level[i]];
+            for (int v = nd.firstValue; v >= 0 && n < max; v = m_values[v].next) {
+                int p = m_values[v].payload;
+                bool seen = false;
+                for (int j = 0; j < n && !seen; j++) seen = out[j] == p;
+                if (!seen && (!accept || accept(p))) out[n++] = p;
+            }
+            for (int c = nd.firstChild; c >= 0; c = m_nodes[c].nextSibling) next.append(c);
+        }
+        // swap levels
+        level.clear();
+        for (int i = 0; i < next.count(); i++) level.append(next[i]);
+    }
+    return n;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <QString>
+#include <QStringView>
+#include <functional>
+#include "arena.h"
+
+// Compact prefix tree for type-ahead pickers.
+// Nodes and payload lists live in two flat arrays (16 + 8 bytes each, no
+// per-node allocation); children are a sorted sibling chain. complete() walks
+// down the prefix and then visits the subtree level by level until it has
+// `max` distinct payloads, so a keystroke costs the prefix length plus the
+// part of the subtree above the matches it shows, not the number of keys.
+// Not thread-safe: the owner locks (see LMSSystem::complete).
+class PrefixTrie {
+    struct Node {
+        char16_t ch;
+        int firstChild;  // -1: leaf
+        int nextSibling; // -1: last child; siblings sorted by ch
+        int firstValue;  // -1: no key ends here
+    };
+    struct Value {
+        int payload;
+        int next;
+    };
+
+    GrowArray<Node> m_nodes; // [0] is the root
+    GrowArray<Value> m_values;
+
+public:
+    PrefixTrie();
+
+    void insert(QStringView key, int payload); // key as given (see normalize)
+    // The whole text and every word start in it ("intro to data" also
+    // under "to data" and "data"), normalized.
+    void insertWords(const QString& text, int payload);
+
+    // Distinct payloads of the keys starting with prefix (normalized by the
+    // caller), shorter keys first, equal lengths in key order. Returns how many were written.
+    int complete(QStringView prefix, int* out, int max, const std::function<bool(int)>& accept = {}) const;
+
+    int nodeCount() const;
+
+    static QString normalize(const QString& text); // lower case, single spaces
+};
@@ -0,0 +1,206 @@
+#include "search_index.h"
+#include <QHash>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+static const float BM25_K1 = 1.2f;
+
+SearchIndex::~SearchIndex() {
+    for (int i = 0; i < m_postings.count(); i++) delete m_postings[i];
+}
+
+void SearchIndex::tokenize(const QString& text, const std::function<void(const QString&)>& token) {
+    QString t;
+    for (QChar ch : text) {
+        if (ch.isLetterOrNumber()) {
+            t += ch.toLower();
+        } else if (!t.isEmpty()) {
+            token(t);
+            t.clear();
+        }
+    }
+    if (!t.isEmpty()) token(t);
+}
+
+void SearchIndex::add(SearchKind kind, int id, const QString* fields, const int* weights, int count) {
+    // tokenized before taking the lock
+    QHash<QString, int> tf;
+    for (int f = 0; f < count; f++) {
+        int w = weights[f];
+        tokenize(fields[f], [&tf, w](const QString& t) { tf[t] += w; });
+    }
+
+    QWriteLocker lock(&m_lock);
+    quint32 doc = quint32(m_docs.count());
+    m_docs.append(DocRef{ kind, id });
+    m_docOf.insert(quint64(kind) << 32 | quint32(id), doc);
+    for (auto it = tf.constBegin(); it != tf.constEnd(); ++it) {
+        auto term = m_terms.constFind(it.key());
+        int t;
+        if (term == m_terms.constEnd()) {
+            t = m_postings.count();
+            m_terms.insert(it.key(), t);
+            m_postings.append(new PostingList);
+        } else {
+            t = term.value();
+        }
+        m_postings[t]->append(Posting{ doc, quint16(qMin(it.value(), 0xffff)) });
+    }
+}
+
+int SearchIndex::documentCount() const {
+    QReadLocker lock(&m_lock);
+    return m_docs.count();
+}
+
+int SearchIndex::termCount() const {
+    QReadLocker lock(&m_lock);
+    return m_postings.count();
+}
+
+// one query token: the terms it matches (several if it is a prefix)
+struct SearchIndex::QueryToken {
+    int lists[SEARCH_MAX_PREFIX_TERMS];
+    int listCount;
+    qint64 df;
+    float idf;
+};
+
+static float weigh(float idf, int tf) {
+    return idf * tf * (BM25_K1 + 1) / (tf + BM25_K1);
+}
+
+int SearchIndex::resolve(const QString& query, QueryToken* q) const {
+    // words; the one being typed (and any ending in '*') is a prefix
+    QString tokens[SEARCH_MAX_QUERY_TOKENS];
+    bool prefix[SEARCH_MAX_QUERY_TOKENS];
+    int tokenCount = 0;
+    const QStringList words = query.split(' ', Qt::SkipEmptyParts);
+    bool typing = !query.endsWith(' ');
+    for (int w = 0; w < words.size(); w++) {
+        bool wordPrefix = words[w].endsWith('*') || (typing && w == words.size() - 1);
+        int first = tokenCount;
+        tokenize(words[w], [&](const QString& t) {
+            if (tokenCount == SEARCH_MAX_QUERY_TOKENS) return;
+            tokens[tokenCount] = t;
+            prefix[tokenCount++] = false;
+        });
+        if (tokenCount > first) prefix[tokenCount - 1] = wordPrefix;
+    }
+
+    qint64 docs = m_docs.count();
+    for (int i = 0; i < tokenCount; i++) {
+        q[i].listCount = 0;
+        q[i].df = 0;
+        if (prefix[i]) {
+            for (auto it = m_terms.lowerBound(tokens[i]);
+                 it != m_terms.constEnd() && it.key().startsWith(tokens[i]) && q[i].listCount < SEARCH_MAX_PREFIX_TERMS; ++it)
+                q[i].lists[q[i].listCount++] = it.value();
+        } else {
+            auto it = m_terms.constFind(tokens[i]);
+            if (it != m_terms.constEnd()) q[i].lists[q[i].listCount++] = it.value();
+        }
+        if (q[i].listCount == 0) return 0; // AND: one unknown token, no hits
+        for (int l = 0; l < q[i].listCount; l++) q[i].df += m_postings[q[i].lists[l]]->count();
+        qint64 df = qMin(q[i].df, docs);
+        q[i].idf = float(std::log(1.0 + (docs - df + 0.5) / (df + 0.5)));
+    }
+    std::sort(q, q + tokenCount, [](const QueryToken& a, const QueryToken& b) { return a.df < b.df; });
+    return tokenCount;
+}
+
+int SearchIndex::termCount(const PostingList& list, quint32 doc) {
+    const Posting* b = list.data();
+    const Posting* e = b + list.count();
+    const Posting* p = std::lower_bound(b, e, doc, [](const Posting& x, quint32 d) { return x.doc < d; });
+    return p != e && p->doc == doc ? int(p->tf) : 0;
+}
+
+void SearchIndex::rank(GrowArray<SearchHit>& hits, GrowArray<SearchHit>& out, int max) {
+    SearchHit* h = hits.data();
+    std::stable_sort(h, h + hits.count(), [](const SearchHit& a, const SearchHit& b) { return a.score > b.score; });
+    int n = qMin(max, hits.count());
+    out.reserve(n);
+    for (int i = 0; i < n; i++) out.append(h[i]);
+}
+
+void SearchIndex::search(const QString& query, GrowArray<SearchHit>& out, int max) const {
+    out.clear();
+    if (max <= 0) return;
+
+    QReadLocker lock(&m_lock);
+    QueryToken q[SEARCH_MAX_QUERY_TOKENS];
+    int tokenCount = resolve(query, q);
+    if (tokenCount == 0) return;
+
+    // candidates: the rarest token's newest postings (prefix: newest of each term, merged)
+    GrowArray<Posting> candidates;
+    if (q[0].listCount == 1) {
+        const PostingList& list = *m_postings[q[0].lists[0]];
+        int from = qMax(0, list.count() - SEARCH_MAX_SCANNED);
+        candidates.reserve(list.count() - from);
+        for (int i = from; i < list.count(); i++) candidates.append(list[i]);
+    } else {
+        for (int l = 0; l < q[0].listCount; l++) {
+            const PostingList& list = *m_postings[q[0].lists[l]];
+            for (int i = qMax(0, list.count() - SEARCH_MAX_SCANNED); i < list.count(); i++) candidates.append(list[i]);
+        }
+        Posting* c = candidates.data();
+        std::sort(c, c + candidates.count(), [](const Posting& a, const Posting& b) { return a.doc < b.doc; });
+        int merged = 0;
+        for (int i = 0; i < candidates.count(); i++) {
+            if (merged > 0 && c[merged - 1].doc == c[i].doc) c[merged - 1].tf += c[i].tf;
+            else c[merged++] = c[i];
+        }
+        candidates.resize(merged);
+    }
+
+    // newest first: among equal scores the newer document stays ahead
+    GrowArray<SearchHit> hits;
+    for (int i = candidates.count() - 1; i >= qMax(0, candidates.count() - SEARCH_MAX_SCANNED); i--) {
+        quint32 doc = candidates[i].doc;
+        float score = weigh(q[0].idf, candidates[i].tf);
+        bool all = true;
+        for (int t = 1; t < tokenCount && all; t++) {
+            int tf = 0;
+            for (int l = 0; l < q[t].listCount; l++) tf += termCount(*m_postings[q[t].lists[l]], doc);
+            if (tf == 0) all = false;
+            else score += weigh(q[t].idf, tf);
+        }
+        if (!all) continue;
+        const DocRef& d = m_docs[int(doc)];
+        hits.append(SearchHit{ d.kind, d.id, score });
+    }
+    lock.unlock();
+    rank(hits, out, max);
+}
+
+void SearchIndex::searchAmong(const QString& query, SearchKind kind, const int* ids, int count,
+    GrowArray<SearchHit>& out, int max) const {
+    out.clear();
+    if (max <= 0) return;
+
+    QReadLocker lock(&m_lock);
+    QueryToken q[SEARCH_MAX_QUERY_TOKENS];
+    int tokenCount = resolve(query, q);
+    if (tokenCount == 0) return;
+
+    GrowArray<SearchHit> hits;
+    quint64 k = quint64(kind) << 32;
+    for (int i = 0; i < qMin(count, SEARCH_MAX_SCANNED); i++) {
+        auto found = m_docOf.constFind(k | quint32(ids[i]));
+        if (found == m_docOf.constEnd()) continue; // not indexed yet
+        float score = 0;
+        bool all = true;
+        for (int t = 0; t < tokenCount && all; t++) {
+            int tf = 0;
+            for (int l = 0; l < q[t].listCount; l++) tf += termCount(*m_postings[q[t].lists[l]], found.value());
+            if (tf == 0) all = false;
+            else score += weigh(q[t].idf, tf);
+        }
+        if (all) hits.append(SearchHit{ kind, ids[i], score });
+    }
+    lock.unlock();
+    rank(hits, out, max);
+}
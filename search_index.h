@@ -0,0 +1,84 @@
+#pragma once
+#include <QHash>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QString>
+#include <functional>
+#include "arena.h"
+#include "constants.h"
+
+enum class SearchKind : quint8 {
+    Course,
+    Assignment,
+    Notification
+};
+
+struct SearchHit {
+    SearchKind kind;
+    int id;
+    float score;
+};
+
+// Inverted index for the dashboards' search boxes.
+//
+// Text is cut into lower-case letter/digit tokens. Each term keeps a posting
+// list (doc, weighted term count) in document order, so documents are only
+// ever appended. A query is the AND of its tokens; the last token (and any
+// token ending in '*') also matches longer terms, for search-as-you-type.
+// Matching starts from the rarest token's postings, newest first, and checks
+// the others by binary search, so a query costs about the size of its
+// rarest token's list, not the number of documents. Hits are ranked BM25
+// style (idf x saturated term count); field weights are given at add().
+// searchAmong() scores a given set of documents instead (one user's inbox),
+// so documents outside it can never crowd it out of the scanned window.
+//
+// add() and search() may run on any thread (add() takes the lock exclusively).
+class SearchIndex {
+    struct Posting {
+        quint32 doc;
+        quint16 tf; // field-weighted occurrences
+    };
+    typedef GrowArray<Posting> PostingList;
+
+    struct DocRef {
+        SearchKind kind;
+        int id;
+    };
+    struct QueryToken;
+
+    mutable QReadWriteLock m_lock;
+    QMap<QString, int> m_terms;          // term -> posting list (sorted: prefix lookups)
+    GrowArray<PostingList*> m_postings;  // by term number
+    GrowArray<DocRef> m_docs;            // by doc number
+    QHash<quint64, quint32> m_docOf;     // (kind, id) -> doc number, for searchAmong()
+
+    // query tokens resolved to posting lists, rarest first; 0 if a token matches nothing
+    int resolve(const QString& query, QueryToken* q) const; // lock held
+    static int termCount(const PostingList& list, quint32 doc);
+    static void rank(GrowArray<SearchHit>& hits, GrowArray<SearchHit>& out, int max);
+
+public:
+    SearchIndex() = default;
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    // One document made of `count` fields, e.g. title (weight 3) + description (1).
+    void add(SearchKind kind, int id, const QString* fields, const int* weights, int count);
+
+    // Best hits first, at most `max`. Looks at no more than SEARCH_MAX_SCANNED
+    // postings of the rarest token, newest first: a query matching more than
+    // that ranks the newest part.
+    void search(const QString& query, GrowArray<SearchHit>& out, int max) const;
+
+    // Like search(), over just these documents (ids of one kind, newest
+    // first; at most SEARCH_MAX_SCANNED of them are looked at).
+    void searchAmong(const QString& query, SearchKind kind, const int* ids, int count,
+        GrowArray<SearchHit>& out, int max) const;
+
+    int documentCount() const;
+    int termCount() const;
+
+    static void tokenize(const QString& text, const std::function<void(const QString&)>& token);
+};
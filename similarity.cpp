@@ -0,0 +1,315 @@
+#include "similarity.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QtConcurrent>
+#include <algorithm>
+
+// 64-bit finalizer (splitmix64): spreads the weak low bits of the rolling hash
+static inline quint64 mix64(quint64 x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static const quint64 ROLL_BASE = 1099511628211ULL;
+
+// one MinHash "permutation" per sketch slot
+struct MinHashSeeds {
+    quint64 v[SIM_MINHASH];
+    MinHashSeeds() {
+        for (int j = 0; j < SIM_MINHASH; j++) v[j] = mix64(quint64(j) + 1);
+    }
+};
+static const MinHashSeeds g_seeds;
+
+QString SimilarityReport::summary() const {
+    QString t = QString("%1 submissions, %2 distinct files").arg(submissions).arg(files);
+    if (unreadable) t += QString(", %1 without a stored file").arg(unreadable);
+    t += QString("\n%1 file pairs compared (of %2 possible), %3 similar submission pairs, %4 ms")
+        .arg(candidates).arg(qint64(files) * (files - 1) / 2).arg(pairs).arg(ms);
+    if (boilerplate) t += QString("\n%1 starter-code fingerprints ignored").arg(boilerplate);
+    if (shared) t += QString("\n%1 unchanged starter files not paired").arg(shared);
+    return t;
+}
+
+SimilarityScan::SimilarityScan(LMSSystem& sys, const Assignment* a)
+    : m_store(sys.blobs()), m_contents(nullptr), m_contentCount(0) {
+    if (!a || !a->course()) return;
+    sys.readCourse(a->course(), [this, a]() {
+        m_subs.reserve(a->submissionCount());
+        for (int i = 0; i < a->submissionCount(); i++) {
+            Submission* s = a->submissionAt(i);
+            m_subs.append(Sub{ s->id(), s, -1, -1 });
+        }
+    });
+}
+
+SimilarityScan::~SimilarityScan() {
+    delete[] m_contents;
+}
+
+int SimilarityScan::pairCount() const { return m_pairs.count(); }
+const SimilarPair& SimilarityScan::pairAt(int i) const { return m_pairs[i]; }
+const SimilarityReport& SimilarityScan::report() const { return m_report; }
+
+void SimilarityScan::fingerprint(Content& c) {
+    QIODevice* dev = m_store.read(c.sha256);
+    if (!dev) {
+        c.readable = false;
+        return;
+    }
+    c.readable = true;
+    QByteArray text = dev->read(SIM_MAX_FILE_BYTES);
+    delete dev;
+
+    // letters and digits only, lower case: reformatting and renamed spacing do not hide a copy
+    uchar* d = reinterpret_cast<uchar*>(text.data());
+    int n = 0;
+    for (int i = 0; i < text.size(); i++) {
+        uchar ch = d[i];
+        if (ch >= 'A' && ch <= 'Z') ch += 'a' - 'A';
+        if ((ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || ch >= 0x80) d[n++] = ch;
+    }
+    if (n < SIM_KGRAM) return;
+
+    // rolling hash of every k-gram
+    int shingles = n - SIM_KGRAM + 1;
+    GrowArray<quint64> h;
+    h.resize(shingles);
+    quint64 top = 1; // ROLL_BASE^(KGRAM-1)
+    for (int i = 1; i < SIM_KGRAM; i++) top *= ROLL_BASE;
+    quint64 x = 0;
+    for (int i = 0; i < SIM_KGRAM; i++) x = x * ROLL_BASE + d[i];
+    h[0] = mix64(x);
+    for (int i = SIM_KGRAM; i < n; i++) {
+        x = (x - d[i - SIM_KGRAM] * top) * ROLL_BASE + d[i];
+        h[i - SIM_KGRAM + 1] = mix64(x);
+    }
+
+    // winnowing: the (rightmost) minimum of every window, recorded when it changes
+    int w = qMin(SIM_WINNOW, shingles);
+    c.prints.reserve(2 * shingles / (w + 1) + 1);
+    int minPos = -1;
+    for (int end = w - 1; end < shingles; end++) {
+        int start = end - w + 1;
+        if (minPos < start) {
+            minPos = start;
+            for (int j = start + 1; j <= end; j++)
+                if (h[j] <= h[minPos]) minPos = j;
+            c.prints.append(h[minPos]);
+        } else if (h[end] <= h[minPos]) {
+            minPos = end;
+            c.prints.append(h[minPos]);
+        }
+    }
+
+    quint64* p = c.prints.data();
+    std::sort(p, p + c.prints.count());
+    c.prints.resize(int(std::unique(p, p + c.prints.count()) - p));
+}
+
+void SimilarityScan::dropBoilerplate() {
+    int files = 0;
+    int total = 0;
+    for (int i = 0; i < m_contentCount; i++) {
+        if (m_contents[i].prints.isEmpty()) continue;
+        files++;
+        total += m_contents[i].prints.count();
+    }
+    // with a handful of files, shared code is as likely copying as starter code
+    if (files < SIM_COMMON_MIN_FILES) return;
+
+    GrowArray<quint64> all;
+    all.reserve(total);
+    for (int i = 0; i < m_contentCount; i++)
+        for (int j = 0; j < m_contents[i].prints.count(); j++) all.append(m_contents[i].prints[j]);
+    std::sort(all.data(), all.data() + all.count());
+
+    // each file's prints are unique, so a run's length is the number of files having it
+    GrowArray<quint64> common;
+    int limit = files * SIM_COMMON_PCT / 100;
+    for (int i = 0; i < all.count();) {
+        int j = i;
+        while (j < all.count() && all[j] == all[i]) j++;
+        if (j - i > limit) common.append(all[i]);
+        i = j;
+    }
+    m_report.boilerplate = common.count();
+    if (common.isEmpty()) return;
+
+    const quint64* cb = common.data();
+    const quint64* ce = cb + common.count();
+    QtConcurrent::blockingMap(m_contents, m_contents + m_contentCount, [cb, ce](Content& c) {
+        int kept = 0;
+        for (int j = 0; j < c.prints.count(); j++)
+            if (!std::binary_search(cb, ce, c.prints[j])) c.prints[kept++] = c.prints[j];
+        c.prints.resize(kept);
+    });
+}
+
+void SimilarityScan::sketch(Content& c) {
+    for (int j = 0; j < SIM_MINHASH; j++) c.sketch[j] = ~quint64(0);
+    for (int i = 0; i < c.prints.count(); i++) {
+        quint64 p = c.prints[i];
+        for (int j = 0; j < SIM_MINHASH; j++) {
+            quint64 v = mix64(p ^ g_seeds.v[j]);
+            if (v < c.sketch[j]) c.sketch[j] = v;
+        }
+    }
+}
+
+void SimilarityScan::addPairs(int contentA, int contentB, float similarity, float containment) {
+    for (int a = m_contents[contentA].firstSub; a >= 0; a = m_subs[a].next) {
+        // same content: each pair once
+        for (int b = contentA == contentB ? m_subs[a].next : m_contents[contentB].firstSub; b >= 0; b = m_subs[b].next) {
+            int x = qMin(m_subs[a].id, m_subs[b].id);
+            int y = qMax(m_subs[a].id, m_subs[b].id);
+            m_pairs.append(SimilarPair{ x, y, similarity, containment });
+        }
+    }
+}
+
+// per LSH band: the content pairs whose band of the sketch collides
+struct BandScan {
+    int band;
+    GrowArray<quint64> pairs; // (a << 32) | b, a < b
+};
+
+struct BandEntry {
+    quint64 key;
+    int content;
+};
+
+struct Candidate {
+    int a;
+    int b;
+    float similarity;
+    float containment;
+};
+
+void SimilarityScan::run() {
+    QElapsedTimer t;
+    t.start();
+    m_report = SimilarityReport();
+    m_report.submissions = m_subs.count();
+
+    // ---- distinct contents (the blob store already tells identical files apart) ----
+    QHash<QByteArray, int> byHash;
+    for (int i = 0; i < m_subs.count(); i++) {
+        QByteArray hash = m_subs[i].sub->contentHash();
+        if (hash.isEmpty()) continue;
+        auto it = byHash.constFind(hash);
+        if (it == byHash.constEnd()) it = byHash.insert(hash, byHash.count());
+        m_subs[i].content = it.value();
+    }
+    delete[] m_contents;
+    m_contentCount = byHash.count();
+    m_contents = new Content[m_contentCount];
+    for (auto it = byHash.constBegin(); it != byHash.constEnd(); ++it) {
+        m_contents[it.value()].sha256 = it.key();
+        m_contents[it.value()].firstSub = -1;
+    }
+    for (int i = m_subs.count() - 1; i >= 0; i--) {
+        int c = m_subs[i].content;
+        if (c < 0) {
+            m_report.unreadable++;
+            continue;
+        }
+        m_subs[i].next = m_contents[c].firstSub;
+        m_contents[c].firstSub = i;
+    }
+    m_report.files = m_contentCount;
+
+    // ---- fingerprints and sketches, one file per task ----
+    QtConcurrent::blockingMap(m_contents, m_contents + m_contentCount, [this](Content& c) { fingerprint(c); });
+    for (int i = 0; i < m_contentCount; i++) {
+        if (m_contents[i].readable) continue;
+        for (int s = m_contents[i].firstSub; s >= 0; s = m_subs[s].next) m_report.unreadable++;
+    }
+    dropBoilerplate();
+    QtConcurrent::blockingMap(m_contents, m_contents + m_contentCount, [this](Content& c) { sketch(c); });
+
+    // ---- LSH: candidate pairs, one band per task ----
+    BandScan* bands = new BandScan[SIM_LSH_BANDS];
+    for (int b = 0; b < SIM_LSH_BANDS; b++) bands[b].band = b;
+    QtConcurrent::blockingMap(bands, bands + SIM_LSH_BANDS, [this](BandScan& band) {
+        GrowArray<BandEntry> entries;
+        entries.reserve(m_contentCount);
+        for (int i = 0; i < m_contentCount; i++) {
+            const Content& c = m_contents[i];
+            if (c.prints.isEmpty()) continue;
+            quint64 key = 0;
+            for (int r = 0; r < SIM_LSH_ROWS; r++) key = mix64(key ^ c.sketch[band.band * SIM_LSH_ROWS + r]);
+            entries.append(BandEntry{ key, i });
+        }
+        BandEntry* e = entries.data();
+        std::sort(e, e + entries.count(), [](const BandEntry& x, const BandEntry& y) {
+            return x.key != y.key ? x.key < y.key : x.content < y.content;
+        });
+        for (int i = 0; i < entries.count();) {
+            int j = i;
+            while (j < entries.count() && e[j].key == e[i].key) j++;
+            for (int x = i; x < j; x++)
+                for (int y = x + 1; y < j; y++) band.pairs.append((quint64(e[x].content) << 32) | quint32(e[y].content));
+            i = j;
+        }
+    });
+
+    GrowArray<quint64> keys;
+    for (int b = 0; b < SIM_LSH_BANDS; b++)
+        for (int i = 0; i < bands[b].pairs.count(); i++) keys.append(bands[b].pairs[i]);
+    delete[] bands;
+    std::sort(keys.data(), keys.data() + keys.count());
+    keys.resize(int(std::unique(keys.data(), keys.data() + keys.count()) - keys.data()));
+
+    // ---- exact Jaccard of the candidates, one pair per task ----
+    GrowArray<Candidate> candidates;
+    candidates.reserve(keys.count());
+    for (int i = 0; i < keys.count(); i++)
+        candidates.append(Candidate{ int(keys[i] >> 32), int(keys[i] & 0xffffffffu), 0.0f, 0.0f });
+    m_report.candidates = candidates.count();
+    QtConcurrent::blockingMap(candidates.data(), candidates.data() + candidates.count(), [this](Candidate& c) {
+        const GrowArray<quint64>& a = m_contents[c.a].prints;
+        const GrowArray<quint64>& b = m_contents[c.b].prints;
+        int i = 0, j = 0, shared = 0;
+        while (i < a.count() && j < b.count()) {
+            if (a[i] < b[j]) i++;
+            else if (b[j] < a[i]) j++;
+            else { shared++; i++; j++; }
+        }
+        c.similarity = float(shared) / float(a.count() + b.count() - shared);
+        c.containment = float(shared) / float(qMin(a.count(), b.count()));
+    });
+
+    // ---- submission pairs, best first ----
+    m_pairs.clear();
+    // identical files pair up, unless more than SIM_COMMON_PCT% of the class
+    // handed in the same one: that is the untouched template, not copying
+    int stored = m_report.submissions - m_report.unreadable;
+    int limit = stored * SIM_COMMON_PCT / 100;
+    for (int i = 0; i < m_contentCount; i++) {
+        if (!m_contents[i].readable) continue;
+        int copies = 0;
+        for (int s = m_contents[i].firstSub; s >= 0; s = m_subs[s].next) copies++;
+        if (stored >= SIM_COMMON_MIN_FILES && copies > limit) {
+            m_report.shared++;
+            continue;
+        }
+        addPairs(i, i, 1.0f, 1.0f);
+    }
+    for (int i = 0; i < candidates.count(); i++)
+        if (candidates[i].similarity >= SIM_REPORT_MIN)
+            addPairs(candidates[i].a, candidates[i].b, candidates[i].similarity, candidates[i].containment);
+    m_report.pairs = m_pairs.count();
+
+    SimilarPair* p = m_pairs.data();
+    std::sort(p, p + m_pairs.count(), [](const SimilarPair& x, const SimilarPair& y) {
+        if (x.similarity != y.similarity) return x.similarity > y.similarity;
+        if (x.containment != y.containment) return x.containment > y.containment;
+        return x.submissionA != y.submissionA ? x.submissionA < y.submissionA : x.submissionB < y.submissionB;
+    });
+    m_pairs.resize(qMin(m_pairs.count(), SIM_MAX_REPORTED_PAIRS));
+    m_report.ms = t.elapsed();
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include "arena.h"
+#include "lms_system.h"
+
+// Copied-work check over one assignment's submissions.
+//
+// 1) Each distinct stored file (submissions with the same blob are identical,
+//    similarity 1) is normalized to lower-case letters and digits, cut into
+//    SIM_KGRAM-character shingles and winnowed to a set of fingerprints.
+//    Fingerprints found in more than SIM_COMMON_PCT% of the files are starter
+//    code, not copying, and are dropped.
+// 2) Each fingerprint set gets a MinHash sketch; LSH over the sketch bands
+//    turns the all-pairs comparison into the few pairs that share a bucket.
+// 3) Only those candidates get the exact fingerprint Jaccard.
+// Steps 1-3 run in parallel (one file / band / candidate per task).
+//
+// Construct on the thread that owns the system, run() on a worker, then read
+// the ranked pairs.
+
+struct SimilarPair {
+    int submissionA;
+    int submissionB;
+    float similarity;  // Jaccard of the fingerprint sets (1: identical files)
+    float containment; // share of the smaller file's fingerprints found in the other
+};
+
+struct SimilarityReport {
+    int submissions = 0;
+    int files = 0;      // distinct contents
+    int unreadable = 0; // submissions without a stored file
+    int boilerplate = 0; // fingerprints dropped as starter code
+    int shared = 0;      // files handed in unchanged by too many to be copying (starter code)
+    int candidates = 0;  // file pairs compared exactly
+    int pairs = 0;       // submission pairs at or above SIM_REPORT_MIN
+    qint64 ms = 0;
+
+    QString summary() const;
+};
+
+class SimilarityScan {
+    struct Sub {
+        int id;
+        Submission* sub;
+        int content; // index in m_contents, -1 if nothing stored
+        int next;    // next submission with the same content, -1 at the end
+    };
+
+    struct Content {
+        QByteArray sha256;
+        int firstSub;
+        GrowArray<quint64> prints; // sorted, unique
+        quint64 sketch[SIM_MINHASH];
+        bool readable;
+    };
+
+    BlobStore& m_store;
+    GrowArray<Sub> m_subs;
+    Content* m_contents;
+    int m_contentCount;
+    GrowArray<SimilarPair> m_pairs; // best first, at most SIM_MAX_REPORTED_PAIRS
+    SimilarityReport m_report;
+
+    void fingerprint(Content& c);
+    void dropBoilerplate();
+    void sketch(Content& c);
+    void addPairs(int contentA, int contentB, float similarity, float containment);
+
+public:
+    SimilarityScan(LMSSystem& sys, const Assignment* a);
+    ~SimilarityScan();
+
+    SimilarityScan(const SimilarityScan&) = delete;
+    SimilarityScan& operator=(const SimilarityScan&) = delete;
+
+    void run();
+
+    int pairCount() const;
+    const SimilarPair& pairAt(int i) const;
+    const SimilarityReport& report() const;
+};
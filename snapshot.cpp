@@ -0,0 +1,416 @@
+#include "snapshot.h"
+#include "lms_system.h"
+#include <QFile>
+#include <QSaveFile>
+#include <cstring>
+
+static_assert(NOTIF_MAX_ARGS <= 3, "SnapNotification stores at most 3 arguments");
+
+static const quint64 SNAP_RECORD_SIZE[SNAP_SECTION_COUNT] = {
+    sizeof(SnapString), sizeof(quint16), sizeof(SnapUser), sizeof(SnapCourse),
+    sizeof(SnapPair), sizeof(SnapPair), sizeof(SnapPair), sizeof(SnapAssignment),
+    sizeof(SnapSubmission), sizeof(SnapPair), sizeof(SnapNotification), sizeof(quint32)
+};
+
+template<typename T>
+static void putRecord(QByteArray& buf, const T& rec) {
+    buf.append(reinterpret_cast<const char*>(&rec), sizeof(T));
+}
+
+// Access to LMSSystem / model internals for saving and loading.
+class SnapshotIO {
+    // ----------------- writing -----------------
+    struct Writer {
+        const StringPool& pool;
+        QByteArray sections[SNAP_SECTION_COUNT];
+        quint64 counts[SNAP_SECTION_COUNT];
+        QHash<QString, quint32> extra; // strings that are not in the pool (file paths)
+
+        explicit Writer(const StringPool& p) : pool(p) {
+            for (int i = 0; i < SNAP_SECTION_COUNT; i++) counts[i] = 0;
+        }
+
+        template<typename T>
+        void put(int section, const T& rec) {
+            putRecord(sections[section], rec);
+            counts[section]++;
+        }
+
+        void putText(QStringView s) {
+            SnapString ref{ quint32(counts[SnapStringData]), quint32(s.size()) };
+            put(SnapStrings, ref);
+            sections[SnapStringData].append(reinterpret_cast<const char*>(s.data()), s.size() * 2);
+            counts[SnapStringData] += quint64(s.size());
+        }
+
+        // file symbols 0..pool.count() are the pool's own symbols
+        void putPool() {
+            put(SnapStrings, SnapString{ 0, 0 });
+            for (int i = 1; i <= pool.count(); i++) putText(pool.view(i));
+        }
+
+        quint32 symbol(QStringView s) {
+            if (s.isEmpty()) return 0;
+            Symbol sym = pool.find(s);
+            if (sym >= 0) return quint32(sym);
+
+            QString key = s.toString();
+            auto it = extra.constFind(key);
+            if (it != extra.constEnd()) return it.value();
+            quint32 fileSym = quint32(counts[SnapStrings]);
+            putText(s);
+            extra.insert(key, fileSym);
+            return fileSym;
+        }
+    };
+
+    static qint32 userId(const User* u) { return u ? u->id() : -1; }
+
+    static void putInbox(Writer& w, const Inbox& inbox, const QHash<const Notification*, quint32>& notifIndex) {
+        if (inbox.m_packed) {
+            // never opened since the last load: same notification order, copy as is
+            w.sections[SnapInboxEntries].append(reinterpret_cast<const char*>(inbox.m_packed),
+                qsizetype(inbox.m_packedCount) * sizeof(quint32));
+            w.counts[SnapInboxEntries] += quint64(inbox.m_packedCount);
+            return;
+        }
+        for (int i = 0; i < inbox.m_items.count(); i++) {
+            quint32 idx = notifIndex.value(inbox.m_items[i].notif, 0);
+            w.put(SnapInboxEntries, quint32((idx << 1) | (inbox.m_items[i].read ? 1u : 0u)));
+        }
+    }
+
+    // ----------------- reading -----------------
+    template<typename T>
+    static const T* section(const uchar* base, const SnapshotHeader* h, int s) {
+        return reinterpret_cast<const T*>(base + h->sections[s].offset);
+    }
+
+public:
+    static bool save(const LMSSystem& sys, const QString& path);
+    static bool load(LMSSystem& sys, const QString& path);
+};
+
+bool SnapshotIO::save(const LMSSystem& sys, const QString& path) {
+    Writer w(sys.m_strings);
+    w.putPool();
+
+    // notification index = creation order (inbox entries refer to it)
+    QHash<const Notification*, quint32> notifIndex;
+    notifIndex.reserve(sys.m_notifs.count());
+    for (int i = 0; i < sys.m_notifs.count(); i++) notifIndex.insert(sys.m_notifs.at(i), quint32(i));
+
+    for (int i = 0; i < sys.m_users.count(); i++) {
+        const User* u = sys.m_users[i];
+        const PasswordRecord& pass = u->passwordRecord();
+
+        SnapUser rec;
+        std::memset(&rec, 0, sizeof(rec));
+        rec.role = quint8(u->role());
+        rec.id = u->id();
+        if (u->role() == Role::Student) rec.roleId = static_cast<const Student*>(u)->studentId();
+        else if (u->role() == Role::Faculty) rec.roleId = static_cast<const Faculty*>(u)->facultyId();
+        else rec.roleId = static_cast<const Admin*>(u)->adminId();
+        rec.name = w.symbol(u->nameView());
+        rec.email = w.symbol(u->emailView());
+        rec.emailKey = w.symbol(LMSSystem::normalizeEmail(u->email()));
+        rec.iterations = pass.iterations;
+        rec.saltLen = quint8(qMin<qsizetype>(pass.salt.size(), SNAP_KEY_BYTES));
+        rec.hashLen = quint8(qMin<qsizetype>(pass.hash.size(), SNAP_KEY_BYTES));
+        std::memcpy(rec.salt, pass.salt.constData(), rec.saltLen);
+        std::memcpy(rec.hash, pass.hash.constData(), rec.hashLen);
+        rec.inboxFirst = quint32(w.counts[SnapInboxEntries]);
+        rec.inboxCount = quint32(u->inbox().count());
+        rec.inboxUnread = quint32(u->inbox().unreadCount());
+        putInbox(w, u->inbox(), notifIndex);
+        w.put(SnapUsers, rec);
+
+        if (u->role() == Role::Student) {
+            const Student* s = static_cast<const Student*>(u);
+            for (int j = 0; j < s->enrolledCount(); j++)
+                w.put(SnapStudentCourses, SnapPair{ s->id(), s->enrolledAt(j)->id() });
+        } else if (u->role() == Role::Faculty) {
+            const Faculty* f = static_cast<const Faculty*>(u);
+            for (int j = 0; j < f->assignedCount(); j++)
+                w.put(SnapFacultyCourses, SnapPair{ f->id(), f->assignedAt(j)->id() });
+            for (int j = 0; j < f->submissionCount(); j++)
+                w.put(SnapFacultyQueue, SnapPair{ f->id(), f->submissionAt(j)->id() });
+        }
+    }
+
+    for (int i = 0; i < sys.m_courses.count(); i++) {
+        const Course* c = sys.m_courses.at(i);
+        w.put(SnapCourses, SnapCourse{ c->id(), w.symbol(c->nameView()), userId(c->faculty()), 0 });
+        for (int j = 0; j < c->studentCount(); j++)
+            w.put(SnapCourseStudents, SnapPair{ c->id(), c->studentAt(j)->id() });
+    }
+
+    for (int i = 0; i < sys.m_assignments.count(); i++) {
+        const Assignment* a = sys.m_assignments.at(i);
+        w.put(SnapAssignments, SnapAssignment{ a->id(), a->course() ? a->course()->id() : -1,
+            w.symbol(a->titleView()), w.symbol(a->descriptionView()), a->m_dueMs });
+    }
+
+    for (int i = 0; i < sys.m_submissions.count(); i++) {
+        const Submission* s = sys.m_submissions.at(i);
+        SnapSubmission rec{ s->id(), userId(s->student()),
+            s->assignment() ? s->assignment()->id() : -1, w.symbol(s->filePath()),
+            s->grade(), quint32(s->status()), s->contentSize(), {} };
+        QByteArray hash = s->contentHash();
+        std::memcpy(rec.sha256, hash.constData(), size_t(qMin<qsizetype>(hash.size(), SNAP_KEY_BYTES)));
+        w.put(SnapSubmissions, rec);
+    }
+
+    for (int i = 0; i < sys.m_notifs.count(); i++) {
+        const Notification* n = sys.m_notifs.at(i);
+        SnapNotification rec;
+        std::memset(&rec, 0, sizeof(rec));
+        rec.timeMs = n->time().toMSecsSinceEpoch();
+        rec.id = n->id();
+        rec.senderUserId = userId(n->sender());
+        rec.tmpl = quint32(n->templateSymbol());
+        rec.argCount = n->argCount();
+        for (int j = 0; j < n->argCount(); j++) rec.args[j] = quint32(n->argSymbol(j));
+        rec.recipientCount = n->recipientCount();
+        w.put(SnapNotifications, rec);
+    }
+
+    SnapshotHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.byteOrder = SNAPSHOT_BYTE_ORDER;
+    h.nextUserId = sys.m_nextUserId;
+    h.nextAdminId = sys.m_nextAdminId;
+    h.nextFacultyId = sys.m_nextFacultyId;
+    h.nextStudentId = sys.m_nextStudentId;
+    h.nextCourseId = sys.m_nextCourseId;
+    h.nextAssignId = sys.m_nextAssignId;
+    h.nextSubId = sys.m_nextSubId;
+    h.nextNotifId = sys.m_nextNotifId;
+    h.deliveryCount = sys.m_deliveryCount;
+    h.journalSeq = sys.m_journal.lastSeq();
+
+    quint64 offset = sizeof(SnapshotHeader);
+    for (int s = 0; s < SNAP_SECTION_COUNT; s++) {
+        h.sections[s].offset = offset;
+        h.sections[s].count = w.counts[s];
+        offset += (quint64(w.sections[s].size()) + 7) & ~quint64(7);
+    }
+
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) return false;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    static const char zeros[8] = { 0 };
+    for (int s = 0; s < SNAP_SECTION_COUNT; s++) {
+        out.write(w.sections[s]);
+        qint64 pad = (8 - w.sections[s].size() % 8) % 8;
+        if (pad) out.write(zeros, pad);
+    }
+    return out.commit(); // atomic rename: a mapped older snapshot is never overwritten in place
+}
+
+bool SnapshotIO::load(LMSSystem& sys, const QString& path) {
+    if (sys.m_users.count() > 0 || sys.m_courses.count() > 0 || sys.m_snapshotFile) return false;
+
+    QFile* file = new QFile(path);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(SnapshotHeader))) {
+        delete file;
+        return false;
+    }
+    quint64 size = quint64(file->size());
+    const uchar* base = file->map(0, qint64(size));
+    if (!base) {
+        delete file;
+        return false;
+    }
+
+    // ---- validate the header and section bounds before touching anything ----
+    const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(base);
+    bool ok = std::memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) == 0 &&
+        h->version == SNAPSHOT_VERSION && h->byteOrder == SNAPSHOT_BYTE_ORDER;
+    for (int s = 0; ok && s < SNAP_SECTION_COUNT; s++) {
+        const SnapSectionRef& ref = h->sections[s];
+        ok = ref.offset % 8 == 0 && ref.offset <= size &&
+            ref.count <= (size - ref.offset) / SNAP_RECORD_SIZE[s];
+    }
+    ok = ok && h->sections[SnapStrings].count >= 1 && h->sections[SnapStrings].count < 0x7fffffff;
+
+    // inbox entries are decoded only when an inbox is opened: every index must
+    // name a notification now, or Inbox::decode() would hand out null entries
+    if (ok) {
+        const quint32* entries = section<quint32>(base, h, SnapInboxEntries);
+        quint64 notifs = h->sections[SnapNotifications].count;
+        for (quint64 i = 0; ok && i < h->sections[SnapInboxEntries].count; i++) ok = (entries[i] >> 1) < notifs;
+    }
+    if (!ok) {
+        delete file;
+        return false;
+    }
+
+    // ---- strings: adopted in place, no copies ----
+    const SnapString* strRefs = section<SnapString>(base, h, SnapStrings);
+    const QChar* strData = section<QChar>(base, h, SnapStringData);
+    quint64 strCount = h->sections[SnapStrings].count;
+    quint64 strUnits = h->sections[SnapStringData].count;
+
+    StringPool& pool = sys.m_strings;
+    Symbol* remap = new Symbol[strCount];
+    remap[0] = 0;
+    for (quint64 k = 1; k < strCount; k++) {
+        const SnapString& r = strRefs[k];
+        if (quint64(r.offset) + r.length > strUnits) {
+            remap[k] = 0;
+            continue;
+        }
+        QStringView text(strData + r.offset, r.length);
+        // the constructor's templates are already interned under the same symbols
+        if (k <= quint64(pool.count()) && pool.view(Symbol(k)) == text) remap[k] = Symbol(k);
+        else remap[k] = pool.adopt(text);
+    }
+    auto sym = [&](quint32 k) { return k < strCount ? remap[k] : 0; };
+    auto view = [&](quint32 k) { return pool.view(sym(k)); };
+
+    // ---- users ----
+    const SnapUser* users = section<SnapUser>(base, h, SnapUsers);
+    const quint32* inboxEntries = section<quint32>(base, h, SnapInboxEntries);
+    quint64 inboxTotal = h->sections[SnapInboxEntries].count;
+    int userCount = int(h->sections[SnapUsers].count);
+    sys.m_userIndex.reserve(userCount);
+    sys.m_emailIndex.reserve(userCount);
+
+    for (int i = 0; i < userCount; i++) {
+        const SnapUser& r = users[i];
+        PasswordRecord pass;
+        pass.salt = QByteArray(reinterpret_cast<const char*>(r.salt), qMin<int>(r.saltLen, SNAP_KEY_BYTES));
+        pass.hash = QByteArray(reinterpret_cast<const char*>(r.hash), qMin<int>(r.hashLen, SNAP_KEY_BYTES));
+        pass.iterations = r.iterations;
+
+        User* u = nullptr;
+        if (r.role == quint8(Role::Admin)) u = sys.m_admins.create(r.id, r.roleId, view(r.name), view(r.email), pass);
+        else if (r.role == quint8(Role::Faculty)) u = sys.m_faculty.create(r.id, r.roleId, view(r.name), view(r.email), pass);
+        else u = sys.m_students.create(r.id, r.roleId, view(r.name), view(r.email), pass);
+
+        sys.m_users.append(u);
+        sys.m_userIndex.insert(u);
+        sys.m_emailIndex.insert(view(r.emailKey), u);
+
+        // inbox stays packed in the file until it is opened
+        if (r.inboxCount > 0 && quint64(r.inboxFirst) + r.inboxCount <= inboxTotal) {
+            Inbox& inbox = u->inbox();
+            inbox.m_packed = inboxEntries + r.inboxFirst;
+            inbox.m_packedCount = int(r.inboxCount);
+            inbox.m_packedSource = &sys.m_notifs;
+            inbox.m_unread = int(qMin(r.inboxUnread, r.inboxCount));
+        }
+    }
+
+    // ---- courses and enrollments ----
+    const SnapCourse* courses = section<SnapCourse>(base, h, SnapCourses);
+    int courseCount = int(h->sections[SnapCourses].count);
+    sys.m_courseIndex.reserve(courseCount);
+    for (int i = 0; i < courseCount; i++) {
+        Course* c = sys.m_courses.create();
+        c->set(courses[i].id, view(courses[i].name));
+        c->setFaculty(sys.asFaculty(sys.findUserById(courses[i].facultyUserId)));
+        sys.m_courseIndex.insert(c);
+    }
+
+    const SnapPair* pairs = section<SnapPair>(base, h, SnapCourseStudents);
+    for (quint64 i = 0; i < h->sections[SnapCourseStudents].count; i++) {
+        Course* c = sys.findCourseById(pairs[i].a);
+        Student* s = sys.asStudent(sys.findUserById(pairs[i].b));
+        if (c && s) c->addStudent(s); // unique when saved
+    }
+    pairs = section<SnapPair>(base, h, SnapStudentCourses);
+    for (quint64 i = 0; i < h->sections[SnapStudentCourses].count; i++) {
+        Student* s = sys.asStudent(sys.findUserById(pairs[i].a));
+        if (s) s->enroll(sys.findCourseById(pairs[i].b));
+    }
+    pairs = section<SnapPair>(base, h, SnapFacultyCourses);
+    for (quint64 i = 0; i < h->sections[SnapFacultyCourses].count; i++) {
+        Faculty* f = sys.asFaculty(sys.findUserById(pairs[i].a));
+        if (f) f->assignCourse(sys.findCourseById(pairs[i].b));
+    }
+
+    // ---- assignments and submissions ----
+    const SnapAssignment* assignments = section<SnapAssignment>(base, h, SnapAssignments);
+    int assignmentCount = int(h->sections[SnapAssignments].count);
+    sys.m_assignmentIndex.reserve(assignmentCount);
+    for (int i = 0; i < assignmentCount; i++) {
+        const SnapAssignment& r = assignments[i];
+        Course* c = sys.findCourseById(r.courseId);
+        Assignment* a = sys.m_assignments.create();
+        a->set(r.id, view(r.title), view(r.description), r.dueMs, c);
+        if (c) c->addAssignment(a);
+        sys.m_assignmentIndex.insert(a);
+        sys.addToGradebook(a);
+    }
+
+    const SnapSubmission* submissions = section<SnapSubmission>(base, h, SnapSubmissions);
+    int submissionCount = int(h->sections[SnapSubmissions].count);
+    sys.m_submissionIndex.reserve(submissionCount);
+    sys.m_submissionByStudent.reserve(submissionCount);
+    for (int i = 0; i < submissionCount; i++) {
+        const SnapSubmission& r = submissions[i];
+        Assignment* a = sys.findAssignmentById(r.assignmentId);
+        Submission* sub = sys.m_submissions.create();
+        sub->set(r.id, sys.asStudent(sys.findUserById(r.studentUserId)), a, pooledString(view(r.filePath)));
+        if (r.status == quint32(SubmissionStatus::Graded)) sub->setGrade(r.grade);
+        static const quint8 noHash[SNAP_KEY_BYTES] = {};
+        if (std::memcmp(r.sha256, noHash, SNAP_KEY_BYTES) != 0) {
+            QByteArray hash(reinterpret_cast<const char*>(r.sha256), SNAP_KEY_BYTES);
+            sub->setContent(hash, r.size);
+            sys.m_blobs.addRef(hash, r.size);
+        }
+        if (a) a->m_submissions.append(sub); // one per student when saved
+        if (a && sub->student()) {
+            sub->student()->addSubmission(sub);
+            sys.m_submissionByStudent.insert(sub->student()->id(), a->id(), sub);
+        }
+        sys.m_submissionIndex.insert(sub);
+        sys.addToGradebook(sub); // rebuilt from the records, not stored
+    }
+
+    pairs = section<SnapPair>(base, h, SnapFacultyQueue);
+    for (quint64 i = 0; i < h->sections[SnapFacultyQueue].count; i++) {
+        Faculty* f = sys.asFaculty(sys.findUserById(pairs[i].a));
+        if (f) f->addSubmission(sys.findSubmissionById(pairs[i].b));
+    }
+
+    // ---- notification payloads (inbox entries point at these by index) ----
+    const SnapNotification* notifs = section<SnapNotification>(base, h, SnapNotifications);
+    for (quint64 i = 0; i < h->sections[SnapNotifications].count; i++) {
+        const SnapNotification& r = notifs[i];
+        Symbol args[NOTIF_MAX_ARGS];
+        int argCount = qBound(0, r.argCount, NOTIF_MAX_ARGS);
+        for (int j = 0; j < argCount; j++) args[j] = sym(r.args[j]);
+
+        Notification* n = sys.m_notifs.create();
+        n->set(r.id, &pool, sym(r.tmpl), args, argCount, sys.findUserById(r.senderUserId),
+            QDateTime::fromMSecsSinceEpoch(r.timeMs));
+        n->addRecipients(r.recipientCount);
+    }
+    delete[] remap;
+
+    sys.m_nextUserId = h->nextUserId;
+    sys.m_nextAdminId = h->nextAdminId;
+    sys.m_nextFacultyId = h->nextFacultyId;
+    sys.m_nextStudentId = h->nextStudentId;
+    sys.m_nextCourseId = h->nextCourseId;
+    sys.m_nextAssignId = h->nextAssignId;
+    sys.m_nextSubId = h->nextSubId;
+    sys.m_nextNotifId = h->nextNotifId;
+    sys.m_deliveryCount = h->deliveryCount;
+    sys.m_snapshotSeq = h->journalSeq;
+
+    sys.m_snapshotFile = file; // keep the mapping alive
+    return true;
+}
+
+// ---------------- LMSSystem entry points ----------------
+bool LMSSystem::saveSnapshot(const QString& path) const {
+    flushNotifications(); // queued notices belong in the inboxes being saved
+    return SnapshotIO::save(*this, path);
+}
+bool LMSSystem::loadSnapshot(const QString& path) { return SnapshotIO::load(*this, path); }
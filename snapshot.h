@@ -0,0 +1,132 @@
+#pragma once
+#include <QtGlobal>
+
+// Binary snapshot of the whole LMSSystem (users, courses, enrollments,
+// assignments, submissions, notifications and inboxes).
+//
+// Layout: one SnapshotHeader, then SNAP_SECTION_COUNT arrays of fixed-size
+// records, each 8-byte aligned. Integers are native little-endian and the
+// records are read straight out of the memory-mapped file - nothing is parsed.
+// - Strings are stored once as UTF-16 and adopted by the StringPool in place.
+// - Inbox entries stay packed in the file until the user opens their inbox;
+//   they are most of the data. Every other record becomes its entity at load.
+// - References are ids (users, courses, ...) or notification record indices.
+// Bump SNAPSHOT_VERSION whenever a record changes.
+
+static const char SNAPSHOT_MAGIC[8] = { 'B', 'L', 'M', 'S', 'S', 'N', 'A', 'P' };
+static const quint32 SNAPSHOT_VERSION = 4; // 2: journalSeq, 3: submission content hash, 4: typed due date
+static const quint32 SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+enum SnapSection {
+    SnapStrings,         // SnapString, index = file symbol (0 unused)
+    SnapStringData,      // quint16 UTF-16 code units
+    SnapUsers,           // SnapUser, creation order
+    SnapCourses,         // SnapCourse, creation order
+    SnapCourseStudents,  // SnapPair (course id, student user id), per course in order
+    SnapStudentCourses,  // SnapPair (student user id, course id), per student in order
+    SnapFacultyCourses,  // SnapPair (faculty user id, course id), per faculty in order
+    SnapAssignments,     // SnapAssignment, creation order
+    SnapSubmissions,     // SnapSubmission, creation order
+    SnapFacultyQueue,    // SnapPair (faculty user id, submission id), grading queue order
+    SnapNotifications,   // SnapNotification, creation order
+    SnapInboxEntries,    // quint32 (notification index << 1) | read
+    SNAP_SECTION_COUNT
+};
+
+struct SnapSectionRef {
+    quint64 offset; // from the start of the file
+    quint64 count;  // records
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+
+    // LMSSystem id generators
+    qint32 nextUserId;
+    qint32 nextAdminId;
+    qint32 nextFacultyId;
+    qint32 nextStudentId;
+    qint32 nextCourseId;
+    qint32 nextAssignId;
+    qint32 nextSubId;
+    qint32 nextNotifId;
+    qint32 deliveryCount;
+    qint32 reserved;
+    quint64 journalSeq; // last journal record included (replay starts after it)
+
+    SnapSectionRef sections[SNAP_SECTION_COUNT];
+};
+
+struct SnapString {
+    quint32 offset; // in UTF-16 units into SnapStringData
+    quint32 length;
+};
+
+static const int SNAP_KEY_BYTES = 32;
+
+struct SnapUser {
+    quint8 role; // Role
+    quint8 saltLen;
+    quint8 hashLen;
+    quint8 reserved;
+    qint32 id;
+    qint32 roleId; // adminId / facultyId / studentId
+    quint32 name;
+    quint32 email;
+    quint32 emailKey; // normalized email (login index key)
+    qint32 iterations;
+    quint32 inboxFirst; // into SnapInboxEntries
+    quint32 inboxCount;
+    quint32 inboxUnread;
+    quint8 salt[SNAP_KEY_BYTES];
+    quint8 hash[SNAP_KEY_BYTES];
+};
+
+struct SnapPair {
+    qint32 a;
+    qint32 b;
+};
+
+struct SnapCourse {
+    qint32 id;
+    quint32 name;
+    qint32 facultyUserId; // -1 = none
+    qint32 reserved;
+};
+
+struct SnapAssignment {
+    qint32 id;
+    qint32 courseId;
+    quint32 title;
+    quint32 description;
+    qint64 dueMs; // ms since epoch, UTC; 0 = none
+};
+
+struct SnapSubmission {
+    qint32 id;
+    qint32 studentUserId;
+    qint32 assignmentId;
+    quint32 filePath;
+    float grade;
+    quint32 status; // SubmissionStatus
+    qint64 size;    // stored file bytes
+    quint8 sha256[SNAP_KEY_BYTES]; // all zero: never ingested
+};
+
+struct SnapNotification {
+    qint64 timeMs; // ms since epoch, UTC
+    qint32 id;
+    qint32 senderUserId; // -1 = system
+    quint32 tmpl;
+    quint32 args[3]; // NOTIF_MAX_ARGS
+    qint32 argCount;
+    qint32 recipientCount;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "snapshot header must keep sections aligned");
+static_assert(sizeof(SnapUser) == 104, "snapshot record layout changed: bump SNAPSHOT_VERSION");
+static_assert(sizeof(SnapAssignment) == 24, "snapshot record layout changed: bump SNAPSHOT_VERSION");
+static_assert(sizeof(SnapSubmission) == 64, "snapshot record layout changed: bump SNAPSHOT_VERSION");
+static_assert(sizeof(SnapNotification) == 40, "snapshot record layout changed: bump SNAPSHOT_VERSION");
@@ -0,0 +1,108 @@
+#include "string_pool.h"
+#include <cstring>
+
+StringPool::StringPool() : m_cursor(nullptr), m_chunkFree(0), m_indexed(1), m_bytes(0) {
+    m_spans.append(Span{ nullptr, 0 }); // Symbol 0 = ""
+}
+
+StringPool::~StringPool() {
+    for (int i = 0; i < m_chunks.count(); i++) ::operator delete(static_cast<void*>(m_chunks[i]));
+}
+
+const QChar* StringPool::store(QStringView s) {
+    int len = int(s.size());
+    QChar* dst;
+
+    if (len > STRING_POOL_CHUNK_CHARS / 4) {
+        // big strings get their own block so they do not waste a chunk tail
+        dst = static_cast<QChar*>(::operator new(sizeof(QChar) * len));
+        m_chunks.append(dst);
+        m_bytes += qint64(sizeof(QChar)) * len;
+    } else {
+        if (len > m_chunkFree) {
+            m_cursor = static_cast<QChar*>(::operator new(sizeof(QChar) * STRING_POOL_CHUNK_CHARS));
+            m_chunks.append(m_cursor);
+            m_chunkFree = STRING_POOL_CHUNK_CHARS;
+            m_bytes += qint64(sizeof(QChar)) * STRING_POOL_CHUNK_CHARS;
+        }
+        dst = m_cursor;
+        m_cursor += len;
+        m_chunkFree -= len;
+    }
+
+    std::memcpy(static_cast<void*>(dst), s.data(), sizeof(QChar) * len);
+    return dst;
+}
+
+void StringPool::indexPending() const {
+    if (m_indexed == m_spans.count()) return;
+    m_lookup.reserve(m_spans.count());
+    for (; m_indexed < m_spans.count(); m_indexed++) {
+        QStringView key(m_spans[m_indexed].data, m_spans[m_indexed].len);
+        if (!m_lookup.contains(key)) m_lookup.insert(key, m_indexed);
+    }
+}
+
+Symbol StringPool::intern(QStringView s) {
+    if (s.isEmpty()) return 0;
+    {
+        // common case: already interned
+        QReadLocker lock(&m_lock);
+        if (m_indexed == m_spans.count()) {
+            auto it = m_lookup.constFind(s);
+            if (it != m_lookup.constEnd()) return it.value();
+        }
+    }
+
+    QWriteLocker lock(&m_lock);
+    indexPending();
+
+    auto it = m_lookup.constFind(s);
+    if (it != m_lookup.constEnd()) return it.value();
+
+    const QChar* data = store(s);
+    Symbol sym = m_spans.count();
+    m_spans.append(Span{ data, int(s.size()) });
+    m_lookup.insert(QStringView(data, s.size()), sym);
+    m_indexed = m_spans.count();
+    return sym;
+}
+
+Symbol StringPool::find(QStringView s) const {
+    if (s.isEmpty()) return 0;
+    {
+        QReadLocker lock(&m_lock);
+        if (m_indexed == m_spans.count()) return m_lookup.value(s, -1);
+    }
+    QWriteLocker lock(&m_lock);
+    indexPending();
+    return m_lookup.value(s, -1);
+}
+
+Symbol StringPool::adopt(QStringView external) {
+    if (external.isEmpty()) return 0;
+    QWriteLocker lock(&m_lock);
+    Symbol sym = m_spans.count();
+    m_spans.append(Span{ external.data(), int(external.size()) });
+    return sym;
+}
+
+QStringView StringPool::view(Symbol sym) const {
+    QReadLocker lock(&m_lock);
+    if (sym <= 0 || sym >= m_spans.count()) return QStringView();
+    return QStringView(m_spans[sym].data, m_spans[sym].len);
+}
+
+QString StringPool::string(Symbol sym) const {
+    return pooledString(view(sym));
+}
+
+int StringPool::count() const {
+    QReadLocker lock(&m_lock);
+    return m_spans.count() - 1;
+}
+
+qint64 StringPool::bytesUsed() const {
+    QReadLocker lock(&m_lock);
+    return m_bytes;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringView>
+#include "arena.h"
+
+// Symbol = index of an interned string in a StringPool. 0 is the empty string.
+typedef int Symbol;
+
+// Interned string table.
+// Every distinct string is stored once, as UTF-16, in large shared chunks
+// (STRING_POOL_CHUNK_CHARS each) that never move or get freed before the pool.
+// Entities keep QStringViews into the pool instead of their own QString copies,
+// and repeated text (names, titles, message templates) costs nothing extra.
+// adopt() registers text that lives elsewhere (a memory-mapped snapshot) without
+// copying it; the lookup table for adopted text is only built on the next intern/find.
+// Thread-safe: lookups and view() share a read lock, only new strings take the
+// write lock. Text handed out never moves, so views stay valid without a lock.
+class StringPool {
+    struct Span {
+        const QChar* data;
+        int len;
+    };
+
+    mutable QReadWriteLock m_lock;
+    GrowArray<QChar*> m_chunks;
+    QChar* m_cursor;  // free space in the current chunk
+    int m_chunkFree;
+    GrowArray<Span> m_spans; // Symbol -> text
+    mutable QHash<QStringView, Symbol> m_lookup; // keys point into the chunks
+    mutable int m_indexed; // symbols below this are in m_lookup
+    qint64 m_bytes;
+
+    const QChar* store(QStringView s);
+    void indexPending() const; // write lock held
+
+public:
+    StringPool();
+    ~StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    Symbol intern(QStringView s);
+    Symbol find(QStringView s) const; // -1 if not interned
+    Symbol adopt(QStringView external);  // no copy: text must outlive the pool
+
+    QStringView view(Symbol sym) const;
+    QString string(Symbol sym) const; // no copy: wraps the pool's buffer
+
+    int count() const;      // distinct strings
+    qint64 bytesUsed() const;
+};
+
+// Zero-copy QString over pooled text (valid as long as the pool lives).
+inline QString pooledString(QStringView v) {
+    return v.isEmpty() ? QString() : QString::fromRawData(v.data(), v.size());
+}
@@ -0,0 +1,38 @@
+#include "submission_ingest.h"
+#include <QElapsedTimer>
+#include "constants.h"
+
+SubmissionIngestor::SubmissionIngestor(BlobStore& store, QObject* parent)
+    : QObject(parent), m_store(store), m_nextTicket(1), m_stopping(false)
+{
+    qRegisterMetaType<IngestedFile>();
+    m_pool.setMaxThreadCount(INGEST_MAX_PARALLEL);
+}
+
+SubmissionIngestor::~SubmissionIngestor() {
+    m_stopping = true; // running copies abort at their next block
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int SubmissionIngestor::ingest(const QString& sourcePath) {
+    int ticket = m_nextTicket++;
+    m_pool.start([this, ticket, sourcePath]() {
+        QElapsedTimer sinceReport;
+        sinceReport.start();
+        auto report = [this, ticket, &sinceReport](qint64 done, qint64 total) {
+            if (m_stopping) return false;
+            if (done == total || sinceReport.elapsed() >= INGEST_PROGRESS_MS) {
+                emit progress(ticket, done, total);
+                sinceReport.restart();
+            }
+            return true;
+        };
+
+        IngestedFile file;
+        QString error;
+        if (m_store.put(sourcePath, file, &error, report)) emit finished(ticket, file);
+        else emit failed(ticket, error);
+    });
+    return ticket;
+}
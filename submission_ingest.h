@@ -0,0 +1,31 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include "blob_store.h"
+
+// Puts submission files into the BlobStore off the GUI thread.
+// At most INGEST_MAX_PARALLEL files stream at a time: more parallel streams
+// only make the disk seek between them, the rest wait in the queue.
+// Signals are delivered to the ingestor's thread (queued).
+class SubmissionIngestor : public QObject {
+    Q_OBJECT
+
+    BlobStore& m_store;
+    QThreadPool m_pool;
+    std::atomic<int> m_nextTicket;
+    std::atomic<bool> m_stopping;
+
+public:
+    explicit SubmissionIngestor(BlobStore& store, QObject* parent = nullptr);
+    ~SubmissionIngestor(); // drops queued copies, waits for running ones
+
+    // Queues one copy; the ticket comes back in the signals.
+    int ingest(const QString& sourcePath);
+
+signals:
+    void progress(int ticket, qint64 done, qint64 total); // at most every INGEST_PROGRESS_MS
+    void finished(int ticket, const IngestedFile& file);
+    void failed(int ticket, const QString& error);
+};
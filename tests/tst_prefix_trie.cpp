@@ -0,0 +1,72 @@
+// PrefixTrie: completion order, word starts and duplicate payloads.
+// Run: ctest (or ./tst_prefix_trie)
+#include <QtTest>
+#include "prefix_trie.h"
+
+class TestPrefixTrie : public QObject {
+    Q_OBJECT
+
+private slots:
+    void shorterKeysFirst();
+    void matchesWordStarts();
+    void dedupesPayloads();
+    void respectsMaxAndFilter();
+};
+
+void TestPrefixTrie::shorterKeysFirst() {
+    PrefixTrie trie;
+    trie.insertWords("Data Structures", 1);
+    trie.insertWords("Database", 2);
+    trie.insertWords("Data", 3);
+    trie.insert(u"datb", 4);
+
+    int out[10];
+    QCOMPARE(trie.complete(u"dat", out, 10), 4);
+    // "data" and "datb" (4, key order), "database" (8), "data structures" (15)
+    QCOMPARE(out[0], 3);
+    QCOMPARE(out[1], 4);
+    QCOMPARE(out[2], 2);
+    QCOMPARE(out[3], 1);
+
+    QCOMPARE(trie.complete(u"datab", out, 10), 1);
+    QCOMPARE(out[0], 2);
+    QCOMPARE(trie.complete(u"x", out, 10), 0);
+}
+
+void TestPrefixTrie::matchesWordStarts() {
+    PrefixTrie trie;
+    trie.insertWords("  Intro   to DATA ", 1);
+
+    int out[4];
+    QCOMPARE(trie.complete(u"intro to d", out, 4), 1);
+    QCOMPARE(trie.complete(u"to data", out, 4), 1);
+    QCOMPARE(trie.complete(u"data", out, 4), 1);
+    QCOMPARE(trie.complete(u"ata", out, 4), 0); // not a word start
+    QCOMPARE(PrefixTrie::normalize("  Intro   to DATA "), QString("intro to data"));
+}
+
+void TestPrefixTrie::dedupesPayloads() {
+    PrefixTrie trie;
+    trie.insertWords("data data", 7); // "data data" and "data"
+    trie.insert(u"data", 7);          // repeat of the head value: not stored again
+    trie.insertWords("data mining", 8);
+
+    int out[10];
+    QCOMPARE(trie.complete(u"d", out, 10), 2);
+    QCOMPARE(out[0], 7);
+    QCOMPARE(out[1], 8);
+}
+
+void TestPrefixTrie::respectsMaxAndFilter() {
+    PrefixTrie trie;
+    for (int i = 0; i < 50; i++) trie.insertWords(QString("course %1").arg(i), i);
+
+    int out[50];
+    QCOMPARE(trie.complete(u"course", out, 5), 5);
+    QCOMPARE(trie.complete(u"course 1", out, 50), 11); // 1, 10..19
+    QCOMPARE(trie.complete(u"course", out, 50, [](int id) { return id % 2 == 0; }), 25);
+    for (int i = 0; i < 25; i++) QVERIFY(out[i] % 2 == 0);
+}
+
+QTEST_APPLESS_MAIN(TestPrefixTrie)
+#include "tst_prefix_trie.moc"
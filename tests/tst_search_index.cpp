@@ -0,0 +1,97 @@
+// SearchIndex: AND queries, prefix (typing) queries and searchAmong().
+// Run: ctest (or ./tst_search_index)
+#include <QtTest>
+#include "search_index.h"
+
+class TestSearchIndex : public QObject {
+    Q_OBJECT
+
+    SearchIndex m_index;
+
+    static bool has(const GrowArray<SearchHit>& hits, SearchKind kind, int id) {
+        for (int i = 0; i < hits.count(); i++)
+            if (hits[i].kind == kind && hits[i].id == id) return true;
+        return false;
+    }
+
+private slots:
+    void initTestCase();
+    void andOfTokens();
+    void lastTokenIsPrefix();
+    void ranksTitleAboveBody();
+    void searchAmongGivenDocuments();
+};
+
+void TestSearchIndex::initTestCase() {
+    const int title[] = { SEARCH_WEIGHT_TITLE };
+    const int both[] = { SEARCH_WEIGHT_TITLE, SEARCH_WEIGHT_BODY };
+    const int body[] = { SEARCH_WEIGHT_BODY };
+    QString c1[] = { "Data Structures" };
+    QString c2[] = { "Database Systems" };
+    QString a3[] = { "Linked lists", "Implement a linked list with data nodes." };
+    QString n4[] = { "Data Structures midterm moved" };
+    QString n5[] = { "Database Systems lab cancelled" };
+    m_index.add(SearchKind::Course, 1, c1, title, 1);
+    m_index.add(SearchKind::Course, 2, c2, title, 1);
+    m_index.add(SearchKind::Assignment, 3, a3, both, 2);
+    m_index.add(SearchKind::Notification, 4, n4, body, 1);
+    m_index.add(SearchKind::Notification, 5, n5, body, 1);
+    QCOMPARE(m_index.documentCount(), 5);
+}
+
+void TestSearchIndex::andOfTokens() {
+    GrowArray<SearchHit> hits;
+    m_index.search("data structures ", hits, 10);
+    QCOMPARE(hits.count(), 2);
+    QVERIFY(has(hits, SearchKind::Course, 1));
+    QVERIFY(has(hits, SearchKind::Notification, 4));
+
+    m_index.search("linked systems ", hits, 10);
+    QCOMPARE(hits.count(), 0);
+    m_index.search("nosuchword data ", hits, 10);
+    QCOMPARE(hits.count(), 0);
+}
+
+void TestSearchIndex::lastTokenIsPrefix() {
+    GrowArray<SearchHit> hits;
+    m_index.search("data ", hits, 10); // whole word: not "database"
+    QCOMPARE(hits.count(), 3);
+    QVERIFY(!has(hits, SearchKind::Course, 2));
+
+    m_index.search("data", hits, 10); // still typing
+    QCOMPARE(hits.count(), 5);
+    m_index.search("datab* lab", hits, 10);
+    QCOMPARE(hits.count(), 1);
+    QVERIFY(has(hits, SearchKind::Notification, 5));
+    m_index.search("data", hits, 2);
+    QCOMPARE(hits.count(), 2);
+}
+
+void TestSearchIndex::ranksTitleAboveBody() {
+    GrowArray<SearchHit> hits;
+    m_index.search("linked ", hits, 10);
+    QCOMPARE(hits.count(), 1);
+    m_index.search("data ", hits, 10);
+    QCOMPARE(hits.count(), 3);
+    QVERIFY(hits[0].kind == SearchKind::Course && hits[0].id == 1);
+    // both body only: the newer one first
+    QVERIFY(hits[1].kind == SearchKind::Notification);
+    QVERIFY(hits[2].kind == SearchKind::Assignment);
+}
+
+void TestSearchIndex::searchAmongGivenDocuments() {
+    const int inbox[] = { 5, 99 }; // 99: never indexed
+    GrowArray<SearchHit> hits;
+    m_index.searchAmong("data", SearchKind::Notification, inbox, 2, hits, 10);
+    QCOMPARE(hits.count(), 1);
+    QCOMPARE(hits[0].id, 5);
+
+    m_index.searchAmong("structures", SearchKind::Notification, inbox, 2, hits, 10);
+    QCOMPARE(hits.count(), 0);
+    const int course[] = { 1 };
+    m_index.searchAmong("data struct", SearchKind::Course, course, 1, hits, 10);
+    QCOMPARE(hits.count(), 1);
+}
+
+QTEST_APPLESS_MAIN(TestSearchIndex)
+#include "tst_search_index.moc"
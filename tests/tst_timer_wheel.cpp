@@ -0,0 +1,96 @@
+// TimerWheel: firing order and timing across level boundaries.
+// Run: ctest (or ./tst_timer_wheel)
+#include <QtTest>
+#include "timer_wheel.h"
+
+// one tick per ms: due times below are ticks
+static const qint64 LEVEL1_SPAN = qint64(1) << 6;
+static const qint64 LEVEL2_SPAN = qint64(1) << 12;
+static const qint64 LEVEL3_SPAN = qint64(1) << 18;
+static const qint64 TOP_SPAN = qint64(1) << 24; // TIMER_WHEEL_LEVELS x 6 bits
+
+class TestTimerWheel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void firesInOrderAcrossLevels();
+    void firesOnTheDueTick();
+    void parksTimersBeyondTopSpan();
+    void pastTimesFireOnNextAdvance();
+    void resetDropsEverything();
+};
+
+void TestTimerWheel::firesInOrderAcrossLevels() {
+    // both sides of every level boundary, scheduled out of order
+    const qint64 due[] = {
+        LEVEL3_SPAN + 1, 1, LEVEL2_SPAN, LEVEL1_SPAN - 1, LEVEL3_SPAN,
+        LEVEL1_SPAN, LEVEL2_SPAN + 1, LEVEL1_SPAN + 1, LEVEL2_SPAN - 1, LEVEL3_SPAN - 1
+    };
+    const int n = int(sizeof(due) / sizeof(due[0]));
+
+    TimerWheel wheel(1);
+    for (int i = 0; i < n; i++) wheel.schedule(due[i], i);
+    QCOMPARE(wheel.pending(), n);
+
+    GrowArray<int> fired;
+    QCOMPARE(wheel.advance(LEVEL3_SPAN + 1, fired), n);
+    QCOMPARE(fired.count(), n);
+    for (int i = 1; i < n; i++) QVERIFY(due[fired[i - 1]] < due[fired[i]]);
+    QCOMPARE(wheel.pending(), 0);
+}
+
+void TestTimerWheel::firesOnTheDueTick() {
+    const qint64 due[] = { 5, LEVEL1_SPAN, LEVEL2_SPAN + 3, LEVEL3_SPAN + LEVEL2_SPAN + 7 };
+    TimerWheel wheel(1);
+    for (int i = 0; i < 4; i++) wheel.schedule(due[i], i);
+
+    GrowArray<int> fired;
+    for (int i = 0; i < 4; i++) {
+        QCOMPARE(wheel.advance(due[i] - 1, fired), 0);
+        QCOMPARE(wheel.advance(due[i], fired), 1);
+        QCOMPARE(fired[fired.count() - 1], i);
+    }
+}
+
+void TestTimerWheel::parksTimersBeyondTopSpan() {
+    TimerWheel wheel(1);
+    wheel.schedule(3 * TOP_SPAN + 5, 1);
+    wheel.schedule(TOP_SPAN + 100, 2);
+
+    GrowArray<int> fired;
+    QCOMPARE(wheel.advance(TOP_SPAN + 99, fired), 0);
+    QCOMPARE(wheel.advance(TOP_SPAN + 100, fired), 1);
+    QCOMPARE(fired[0], 2);
+    QCOMPARE(wheel.advance(3 * TOP_SPAN + 4, fired), 0);
+    QCOMPARE(wheel.pending(), 1);
+    QCOMPARE(wheel.advance(3 * TOP_SPAN + 5, fired), 1);
+    QCOMPARE(fired[1], 1);
+    QCOMPARE(wheel.pending(), 0);
+}
+
+void TestTimerWheel::pastTimesFireOnNextAdvance() {
+    TimerWheel wheel(60000);
+    GrowArray<int> fired;
+    wheel.advance(10 * 60000, fired);
+
+    wheel.schedule(60000, 7);          // already past
+    wheel.schedule(10 * 60000 + 1, 8); // rounds up to the next tick
+    QCOMPARE(wheel.advance(10 * 60000 + 59999, fired), 0);
+    QCOMPARE(wheel.advance(11 * 60000, fired), 2);
+    QCOMPARE(fired[0] + fired[1], 15);
+}
+
+void TestTimerWheel::resetDropsEverything() {
+    TimerWheel wheel(1);
+    for (int i = 0; i < 100; i++) wheel.schedule(i * 1000 + 1, i);
+    wheel.reset(500);
+    QCOMPARE(wheel.pending(), 0);
+
+    GrowArray<int> fired;
+    QCOMPARE(wheel.advance(200000, fired), 0);
+    wheel.schedule(200010, 1); // freed slots are reused
+    QCOMPARE(wheel.advance(200010, fired), 1);
+}
+
+QTEST_APPLESS_MAIN(TestTimerWheel)
+#include "tst_timer_wheel.moc"
@@ -0,0 +1,93 @@
+#include "timer_wheel.h"
+
+static const int SLOT_BITS = 6;
+static_assert(TIMER_WHEEL_SLOTS == 1 << SLOT_BITS, "TIMER_WHEEL_SLOTS must be 1 << SLOT_BITS");
+
+TimerWheel::TimerWheel(qint64 tickMs) : m_tickMs(qMax<qint64>(1, tickMs)), m_now(0), m_free(-1), m_pending(0) {
+    reset(0);
+}
+
+void TimerWheel::reset(qint64 nowMs) {
+    m_now = nowMs / m_tickMs;
+    m_timers.clear();
+    m_free = -1;
+    m_pending = 0;
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++) m_slots[l][s] = -1;
+}
+
+int TimerWheel::pending() const { return m_pending; }
+qint64 TimerWheel::tickMs() const { return m_tickMs; }
+
+// coarsest level whose span still tells the due tick apart from now;
+// beyond the top level's span it waits in the top level and is placed again
+void TimerWheel::place(int t) {
+    qint64 delta = m_timers[t].due - m_now;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (qint64(1) << (SLOT_BITS * (level + 1)))) level++;
+    int slot = int((m_timers[t].due >> (SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    m_timers[t].next = m_slots[level][slot];
+    m_slots[level][slot] = t;
+}
+
+int TimerWheel::detach(int level, int slot) {
+    int head = m_slots[level][slot];
+    m_slots[level][slot] = -1;
+    return head;
+}
+
+void TimerWheel::schedule(qint64 atMs, int payload) {
+    qint64 due = atMs / m_tickMs + (atMs % m_tickMs > 0 ? 1 : 0);
+    if (due <= m_now) due = m_now + 1;
+
+    int t;
+    if (m_free >= 0) {
+        t = m_free;
+        m_free = m_timers[t].next;
+        m_timers[t] = Timer{ due, payload, -1 };
+    } else {
+        t = m_timers.count();
+        m_timers.append(Timer{ due, payload, -1 });
+    }
+    m_pending++;
+    place(t);
+}
+
+int TimerWheel::advance(qint64 nowMs, GrowArray<int>& fired) {
+    qint64 target = nowMs / m_tickMs;
+    int n = 0;
+    while (m_now < target) {
+        if (m_pending == 0) { // nothing can fire: skip the empty ticks
+            m_now = target;
+            break;
+        }
+        m_now++;
+
+        // entering a new span of level l: its slot for this span moves down
+        for (int l = 1; l < TIMER_WHEEL_LEVELS; l++) {
+            if (m_now & ((qint64(1) << (SLOT_BITS * l)) - 1)) break;
+            int t = detach(l, int((m_now >> (SLOT_BITS * l)) & (TIMER_WHEEL_SLOTS - 1)));
+            while (t >= 0) {
+                int next = m_timers[t].next;
+                place(t);
+                t = next;
+            }
+        }
+
+        int t = detach(0, int(m_now & (TIMER_WHEEL_SLOTS - 1)));
+        while (t >= 0) {
+            int next = m_timers[t].next;
+            if (m_timers[t].due <= m_now) {
+                fired.append(m_timers[t].payload);
+                n++;
+                m_pending--;
+                m_timers[t].next = m_free;
+                m_free = t;
+            } else {
+                place(t); // parked at the top level beyond its span
+            }
+            t = next;
+        }
+    }
+    return n;
+}
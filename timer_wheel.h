@@ -0,0 +1,54 @@
+#pragma once
+#include <QtGlobal>
+#include "arena.h"
+#include "constants.h"
+
+// Hierarchical timer wheel for far-apart, mostly-future deadlines.
+//
+// Time runs in ticks of tickMs. Level 0 has one slot per tick for the next
+// TIMER_WHEEL_SLOTS ticks; each level above covers TIMER_WHEEL_SLOTS times
+// the span of the one below with the same number of slots. A timer goes into
+// the coarsest slot that still separates it from now, and moves one level
+// down (cascades) when time reaches that slot, until it fires from level 0.
+// schedule() is O(1); advance() costs O(1) per tick plus the timers it moves
+// or fires, so each timer is touched at most once per level - there is never
+// a scan over everything pending.
+//
+// Timers live in one array with a free list; a payload is an int the owner
+// decodes. Not thread-safe: the owner locks.
+class TimerWheel {
+    struct Timer {
+        qint64 due; // tick
+        int payload;
+        int next; // next in slot / free list, -1 at the end
+    };
+
+    qint64 m_tickMs;
+    qint64 m_now; // last tick advanced to
+    GrowArray<Timer> m_timers;
+    int m_free;
+    int m_pending;
+    int m_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; // first timer, -1 empty
+
+    void place(int t);
+    int detach(int level, int slot); // whole slot list, emptied
+
+public:
+    explicit TimerWheel(qint64 tickMs);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Drops every timer; time starts at nowMs.
+    void reset(qint64 nowMs);
+
+    // Fires at the first tick at or after atMs (the next advance() if that is past).
+    void schedule(qint64 atMs, int payload);
+
+    // Moves time to nowMs and appends the payloads that came due, earliest first.
+    // Returns how many fired.
+    int advance(qint64 nowMs, GrowArray<int>& fired);
+
+    int pending() const;
+    qint64 tickMs() const;
+};